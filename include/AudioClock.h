@@ -0,0 +1,41 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Maps sample positions of the audio stream (FMOD DSP clock or decoded sample count) to steady_clock time and back.
+// sync() is fed (position, time) observations. The mapping slews towards them so a block sized step
+// in the observed clock does not show up as jitter, and jumps to them when they disagree by a lot (a stall or a seek).
+class AudioClock
+{
+public:
+    explicit AudioClock(const int sampleRateArg);
+
+    void sync(const uint64_t samplePosition, const std::chrono::steady_clock::time_point time);
+
+    std::chrono::steady_clock::time_point toTime(const uint64_t samplePosition) const;
+    uint64_t toSamples(const std::chrono::steady_clock::time_point time) const;
+
+    // Seconds between two sample positions, negative when to is before from
+    double secondsBetween(const uint64_t from, const uint64_t to) const
+    {
+        return (double(to) - double(from)) / sampleRate;
+    }
+
+    int getSampleRate() const
+    {
+        return sampleRate;
+    }
+    bool isSynced() const
+    {
+        return synced;
+    }
+
+private:
+    const int sampleRate;
+
+    bool synced{ false };
+    uint64_t lastObserved{ 0 };
+    uint64_t anchorPosition{ 0 };
+    std::chrono::steady_clock::time_point anchorTime;
+};
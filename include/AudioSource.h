@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+// Pull based source of interleaved float PCM, used where audio is analysed without playing it
+class AudioSource
+{
+public:
+    virtual ~AudioSource() = default;
+
+    virtual int getSampleRate() const = 0;
+    virtual int getChannels() const = 0;
+    // Frames in the whole source, 0 when unknown
+    virtual uint64_t getLength() const = 0;
+
+    // Reads up to frames frames into interleaved, returns how many were read, 0 at the end
+    virtual int read(float* interleaved, const int frames) = 0;
+
+    // Moves the read position to a frame, returns false if the source can not do that
+    virtual bool seek(const uint64_t frame) = 0;
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+struct SmoothingConfig
+{
+    float attackTime{ 0.01f };   // seconds to get ~63% of the way up to a higher value
+    float releaseTime{ 0.25f };  // seconds to get ~63% of the way down to a lower value
+    float peakHoldTime{ 0.6f };  // seconds a peak marker stays put before falling
+    float peakFallSpeed{ 0.5f };  // full heights per second
+};
+
+// Attack/release envelope and peak hold for every bar.
+// The coefficients come from the elapsed time, so the bars move the same at any frame rate.
+// State is kept as separate arrays, the update loop has no branches and vectorises.
+class BarSmoother
+{
+public:
+    BarSmoother(const int bucketsArg, const SmoothingConfig& configArg = SmoothingConfig{});
+
+    // targets are 0.0-1.0, dt is in seconds
+    void update(const std::vector<float>& targets, const float dt);
+
+    const std::vector<float>& getValues() const
+    {
+        return values;
+    }
+    const std::vector<float>& getPeaks() const
+    {
+        return peaks;
+    }
+
+private:
+    const int buckets;
+    SmoothingConfig config;
+
+    std::vector<float> values;
+    std::vector<float> peaks;
+    std::vector<float> peakAges;  // seconds since the peak was last pushed up
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "SpectrumFrame.h"
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+struct BeatDetectorConfig
+{
+    int history{ 100 };  // frames the average and variance are taken over
+    float varianceSlope{ -25.714f };
+    float multiplierBase{ 1.5142857f };  // threshold is (varianceSlope * variance + multiplierBase) * average
+    bool useBands{ false };              // restrict the energy to bands instead of the whole spectrum
+    std::vector<std::pair<float, float>> bands{
+        { 60.0f, 250.0f },     // Kick
+        { 60.0f, 210.0f },     // Toms
+        { 120.0f, 250.0f },    // Snare
+        { 3000.0f, 5000.0f },  // hi-hat
+    };
+};
+
+struct BeatEvent
+{
+    uint64_t samplePosition{ 0 };
+    float energy{ 0.0f };
+};
+
+// Energy based beat detection: a frame is a beat when its energy stands out from the recent average
+// by more than a threshold that tightens as the recent energies vary more.
+class BeatDetector
+{
+public:
+    explicit BeatDetector(const BeatDetectorConfig& configArg = BeatDetectorConfig{});
+
+    std::optional<BeatEvent> process(const SpectrumFrame& frame);
+    // Same decision from a precomputed frame energy
+    std::optional<BeatEvent> process(const float energy, const uint64_t samplePosition);
+
+    void reset();
+
+    float getLastMultiplier() const
+    {
+        return lastMultiplier;
+    }
+    const BeatDetectorConfig& getConfig() const
+    {
+        return config;
+    }
+
+private:
+    BeatDetectorConfig config;
+
+    std::vector<float> memory;
+    size_t memoryPtr{ 0 };
+    float lastMultiplier{ 0.0f };
+};
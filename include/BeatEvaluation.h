@@ -0,0 +1,34 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+// Detections against annotated beats, each annotation can be matched by one detection only
+struct DetectionScore
+{
+    int truePositives{ 0 };
+    int falsePositives{ 0 };
+    int falseNegatives{ 0 };
+
+    float precision() const;
+    float recall() const;
+    float fMeasure() const;
+
+    DetectionScore& operator+=(const DetectionScore& other);
+};
+
+// Both lists in seconds and ascending, tolerance is how far off a detection may be on either side
+DetectionScore scoreBeats(const std::vector<double>& detected, const std::vector<double>& annotated, const double tolerance = 0.07);
+
+// Beat annotations as text, the first number on every line is a beat time in seconds.
+// Lines that do not start with a number (comments, headers) are skipped.
+std::vector<double> loadAnnotations(const std::filesystem::path& path);
+
+// The annotation file next to an audio file: same name with .beats or .txt, empty if there is none
+std::filesystem::path findAnnotations(const std::filesystem::path& audioPath);
+
+// Extensions the evaluation and sweep tools decode
+bool isAudioFile(const std::filesystem::path& path);
+
+// Audio files in folder that have annotations next to them, sorted by path. Empty if folder is not a directory.
+std::vector<std::filesystem::path> findAnnotatedSounds(const std::filesystem::path& folder);
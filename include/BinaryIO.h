@@ -0,0 +1,16 @@
+#pragma once
+
+#include <fstream>
+
+// Raw native endian values for the binary caches and recordings, files are read back on the machine that wrote them
+template<typename T>
+void writeValue(std::ofstream& file, const T& value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool readValue(std::ifstream& file, T& value)
+{
+    return bool(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
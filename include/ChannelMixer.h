@@ -0,0 +1,40 @@
+#pragma once
+
+#include "SpectrumFrame.h"
+
+#include <vector>
+
+struct FMOD_DSP_PARAMETER_FFT;
+
+enum class ChannelLayout
+{
+    Mono,        // every input channel averaged into one
+    MidSide,     // (L + R) / 2 and |L - R| / 2 from the front pair
+    PerChannel,  // input channels kept as they are
+};
+
+// Converts the channel layout of the incoming spectrum once per hop,
+// so the analysis functions only ever see the channels they should work on.
+class ChannelMixer
+{
+public:
+    ChannelMixer(const ChannelLayout layoutArg);
+
+    void process(const FMOD_DSP_PARAMETER_FFT* fftData, SpectrumFrame& frame) const;
+    // Same conversion on interleaved PCM, where mid/side is exact
+    void process(const float* interleaved, const int inputChannels, const int frames, std::vector<float>& out) const;
+
+    ChannelLayout getLayout() const
+    {
+        return layout;
+    }
+    void setLayout(const ChannelLayout layoutArg)
+    {
+        layout = layoutArg;
+    }
+
+    static int outputChannels(const ChannelLayout layout, const int inputChannels);
+
+private:
+    ChannelLayout layout;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "BeatEvaluation.h"
+#include "OfflineAnalyser.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+class AudioSource;
+
+// Accuracy and speed of the offline analysis over one source
+struct EvaluationResult
+{
+    std::string name;
+    DetectionScore score;
+    int beats{ 0 };
+    double audioSeconds{ 0.0 };
+    double analysisSeconds{ 0.0 };
+
+    // How many times faster than real time the source was analysed
+    double realTime() const;
+};
+
+// Analyses the source on the calling thread and scores the beats against annotations (seconds from the start of the source).
+// The analysed chart is kept in chart when that is given.
+EvaluationResult evaluateSource(AudioSource& source, const std::vector<double>& annotations, const OfflineAnalyser& analyser, const std::string& name,
+    const double tolerance = 0.07, Chart* chart = nullptr);
+
+// Prints where the parallel analysis of a source differs from the sequential one, returns whether they hold the same beats
+bool compareParallel(const Chart& sequential, const Chart& parallel, const std::string& name);
+
+// Generated click tracks and drum loops with known beats, so there is something to evaluate without annotated recordings
+std::vector<EvaluationResult> evaluateSynthetic(const OfflineAnalyser& analyser, const double tolerance = 0.07);
+
+// The --evaluate mode: the synthetic tracks and every annotated sound in folder, printed per source and in total.
+// Annotated sounds are analysed in parallel as well, that has to find the same beats.
+int runEvaluationTool(const std::filesystem::path& folder, const OfflineAnalysisConfig& config);
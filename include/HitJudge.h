@@ -0,0 +1,35 @@
+#pragma once
+
+#include "BeatDetector.h"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+struct JudgedPress
+{
+    uint64_t samplePosition{ 0 };
+    bool hit{ false };
+    int64_t offset{ 0 };  // samples from the beat it was matched with, positive when late
+};
+
+// Matches key presses with detected beats by sample position.
+// A press is judged once the analysis has passed the end of its window, so beats detected
+// shortly after the press still count. Every beat can be claimed by one press only.
+class HitJudge
+{
+public:
+    HitJudge(const int sampleRate, const float windowSeconds = 0.1f);
+
+    void addBeat(const BeatEvent& beat);
+    void addPress(const uint64_t samplePosition);
+
+    // analysedPosition is the latest sample position the detector has seen
+    void judge(const uint64_t analysedPosition, std::vector<JudgedPress>& out);
+
+private:
+    const uint64_t window;
+
+    std::deque<uint64_t> beats;  // unclaimed, ascending
+    std::deque<uint64_t> presses;  // not judged yet, ascending
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "OfflineAnalyser.h"
+
+#include <cstdint>
+#include <vector>
+
+enum class Judgement
+{
+    Perfect,
+    Good,
+    Miss,
+};
+
+struct JudgeConfig
+{
+    float perfectWindow{ 0.045f };  // seconds either side of a beat
+    float goodWindow{ 0.1f };
+    int perfectScore{ 300 };
+    int goodScore{ 100 };
+};
+
+struct JudgeResult
+{
+    Judgement judgement{ Judgement::Miss };
+    int beat{ -1 };       // index into the chart, -1 for a press that was nowhere near a beat
+    int64_t offset{ 0 };  // samples, positive when late
+};
+
+// Judges presses against a precomputed chart.
+// Lookups are binary searches over the sorted beat positions and misses are collected as time moves on,
+// so the cost of a press does not depend on how long the song is.
+class JudgeEngine
+{
+public:
+    JudgeEngine(const Chart& chart, const JudgeConfig& configArg = JudgeConfig{});
+
+    // samplePosition is in the chart's samples
+    JudgeResult press(const uint64_t samplePosition);
+
+    // Beats whose window closed before samplePosition without being hit become misses, returns how many
+    int advance(const uint64_t samplePosition);
+
+    int getScore() const
+    {
+        return score;
+    }
+    int getCombo() const
+    {
+        return combo;
+    }
+    int getMaxCombo() const
+    {
+        return maxCombo;
+    }
+    int getCount(const Judgement judgement) const
+    {
+        return counts[int(judgement)];
+    }
+
+private:
+    void record(const Judgement judgement);
+
+    JudgeConfig config;
+    uint64_t perfectWindow;
+    uint64_t goodWindow;
+
+    std::vector<uint64_t> positions;
+    std::vector<bool> judged;
+    size_t firstOpen{ 0 };  // every beat before this one has been judged
+
+    int score{ 0 };
+    int combo{ 0 };
+    int maxCombo{ 0 };
+    int counts[3]{ 0, 0, 0 };
+};
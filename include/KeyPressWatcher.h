@@ -1,38 +1,44 @@
 #pragma once
 
+#include "SpscQueue.h"
+
 #include <chrono>
 
 struct GLFWwindow;
 
+struct KeyPress
+{
+    std::chrono::steady_clock::time_point time;
+    bool pressed{ true };  // false for a release
+};
+
+// Collects presses and releases of one key through the GLFW key callback.
+// Every event is timestamped when GLFW delivers it, not when the frame gets around to looking,
+// so the resolution depends on how often events are processed rather than on the frame rate.
 class KeyPressWatcher
 {
 public:
     KeyPressWatcher(const int keyToWatch);
 
-    void update(GLFWwindow* window);
+    // Takes over the window's key callback, the one installed before keeps receiving every key
+    void install(GLFWwindow* window);
+
+    // Oldest event not taken yet
+    bool poll(KeyPress& event);
 
-    bool isOK() const;
     bool isPressed() const
     {
         return pressed;
     }
 
-    void setGraceTime(const long long msecs)
-    {
-        msecGrace = msecs;
-    }
-    void setPenaltyTime(const long long msecs)
-    {
-        msecPenalty = msecs;
-    }
-
 private:
-    const int watchedKey;
+    static void keyCallback(GLFWwindow* window, const int key, const int scancode, const int action, const int mods);
 
-    std::chrono::steady_clock::time_point lastUpdateTime{ std::chrono::steady_clock::now() };
-
-    long long msecPenalty{ 0 };
-    long long msecGrace{ 0 };
+    const int watchedKey;
 
+    SpscQueue<KeyPress> events{ 64 };
     bool pressed{ false };
-};
\ No newline at end of file
+
+    using KeyCallback = void (*)(GLFWwindow*, int, int, int, int);
+    KeyCallback previousCallback{ nullptr };
+};
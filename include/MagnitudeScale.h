@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+
+enum class MagnitudeWeighting
+{
+    None,
+    A,  // IEC 61672 A-weighting, roughly how loud each frequency sounds at moderate levels
+};
+
+struct MagnitudeScaleConfig
+{
+    MagnitudeWeighting weighting{ MagnitudeWeighting::A };
+    float floorDb{ -90.0f };  // levels at or below this map to 0
+};
+
+// Converts linear magnitudes into weighted dB above a floor, so every value stays non-negative.
+// Works on bucket outputs or on whole spectra, the weights are computed once for the given frequencies.
+class MagnitudeScale
+{
+public:
+    MagnitudeScale(const std::vector<float>& frequencies, const MagnitudeScaleConfig& configArg = MagnitudeScaleConfig{});
+
+    // count has to be at most the number of frequencies the scale was built for
+    void apply(float* values, const int count) const;
+    void apply(std::vector<float>& values) const;
+
+    static float aWeightingDb(const float frequency);
+
+private:
+    MagnitudeScaleConfig config;
+    float floorMagnitude;
+
+    std::vector<float> offsets;  // weighting minus floor in dB, per frequency
+};
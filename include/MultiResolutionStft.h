@@ -0,0 +1,69 @@
+#pragma once
+
+#include "PcmRingBuffer.h"
+#include "Stft.h"
+
+#include <memory>
+#include <vector>
+
+// Several STFTs of different sizes reading the same PCM ring.
+// Frames of every resolution are centred on the same sample positions where their hops allow it,
+// so a short onset frame and a long display frame from the same moment describe the same audio.
+class MultiResolutionStft
+{
+public:
+    // The ring holds twice the longest window unless a larger capacity is given.
+    // startPosition is the sample position of the first frame written, frames carry positions relative to it.
+    MultiResolutionStft(const int channels, const std::vector<StftConfig>& configs, const uint64_t startPosition = 0, const int ringCapacity = 0);
+
+    void write(const float* interleaved, const int frames);
+    void writeSilence(const int frames);
+
+    // Next frame of a single resolution, see Stft::next
+    bool next(const int resolution, SpectrumFrame& frame);
+
+    // Hands every available frame of every resolution to callback(resolution, frame).
+    // Of the frames that are ready the one with the earliest centre goes first, short windows never wait for long ones.
+    template<typename Callback>
+    void process(SpectrumFrame& frame, Callback&& callback)
+    {
+        for (;;)
+        {
+            int earliest = -1;
+            for (int i = 0; i < getResolutions(); ++i)
+            {
+                if (isReady(i) && (earliest < 0 || getNextCentre(i) < getNextCentre(earliest)))
+                {
+                    earliest = i;
+                }
+            }
+
+            if (earliest < 0 || !next(earliest, frame))
+            {
+                return;
+            }
+            callback(earliest, static_cast<const SpectrumFrame&>(frame));
+        }
+    }
+
+    int getResolutions() const
+    {
+        return int(stfts.size());
+    }
+    const Stft& getStft(const int resolution) const
+    {
+        return *stfts[resolution];
+    }
+    const PcmRingBuffer& getRing() const
+    {
+        return ring;
+    }
+
+    // Sample position in the middle of the frame the resolution produces next
+    uint64_t getNextCentre(const int resolution) const;
+    bool isReady(const int resolution) const;
+
+private:
+    PcmRingBuffer ring;
+    std::vector<std::unique_ptr<Stft>> stfts;
+};
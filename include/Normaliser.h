@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+enum class NormalisationReference
+{
+    Peak,  // decaying peak of the bucket values
+    Rms,   // running RMS of the bucket values times a headroom factor
+};
+
+struct NormaliserConfig
+{
+    NormalisationReference reference{ NormalisationReference::Peak };
+    float peakReleaseTime{ 4.0f };  // seconds for the peak reference to fall to ~37%
+    float rmsTime{ 2.0f };          // averaging time of the running RMS
+    float rmsHeadroom{ 4.0f };      // multiplier applied to the RMS, roughly the crest factor of the spectrum
+
+    bool decibels{ false };
+    float noiseFloorDb{ -60.0f };  // relative to the reference, maps to 0.0 in dB mode
+
+    float minimumReference{ 1e-6f };  // keeps digital silence from dividing by zero
+};
+
+// Scales bucket values into 0.0-1.0 against a long-term reference level instead of the loudest bucket of the current frame,
+// so quiet passages stay quiet and bar heights can be compared across frames.
+// Updating the reference is O(1) per frame on top of one pass over the buckets.
+class Normaliser
+{
+public:
+    Normaliser(const NormaliserConfig& configArg = NormaliserConfig{});
+
+    // dt is the time since the previous analysis frame in seconds
+    void process(std::vector<float>& values, const float dt);
+
+    float getReference() const;
+
+private:
+    NormaliserConfig config;
+
+    float peak{ 0.0f };
+    float meanSquare{ 0.0f };
+};
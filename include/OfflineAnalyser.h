@@ -0,0 +1,65 @@
+#pragma once
+
+#include "BeatDetector.h"
+#include "ChannelMixer.h"
+#include "Stft.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class AudioSource;
+
+// Beats of a whole track, worked out before it is played
+struct Chart
+{
+    int sampleRate{ 0 };
+    uint64_t length{ 0 };           // frames
+    std::vector<BeatEvent> beats;  // ascending sample positions, counted from the start of the source
+};
+
+struct OfflineAnalysisConfig
+{
+    ChannelLayout layout{ ChannelLayout::Mono };
+    StftConfig stft{ 1024, 441 };
+    BeatDetectorConfig detector;
+    float minBeatInterval{ 0.1f };  // seconds, the detector fires on consecutive hops of one onset and those become one beat
+    int blockFrames{ 4096 };  // read from the source at once
+};
+
+// Runs the same STFT and beat detector as the live view over a source as fast as it decodes
+class OfflineAnalyser
+{
+public:
+    explicit OfflineAnalyser(const OfflineAnalysisConfig& configArg = OfflineAnalysisConfig{});
+
+    Chart analyse(AudioSource& source) const;
+
+    // Same chart as analyse(), with the source split into segments analysed on several threads.
+    // openSource is called once per thread on the calling thread and has to open the same audio every time.
+    // Sources that can not seek or do not know their length are analysed sequentially.
+    using SourceFactory = std::function<std::unique_ptr<AudioSource>()>;
+    Chart analyseParallel(const SourceFactory& openSource, int threads = 0) const;
+
+    // Hands every analysis frame from startSample on to visit, which returns false to stop early.
+    // The source is seeked to a little before startSample, so the decoder has settled by then.
+    // Returns the source position reading stopped at, the frame count read for a start at 0, or 0 if the source could not be read.
+    uint64_t forEachFrame(AudioSource& source, Stft& stft, const uint64_t startSample, const std::function<bool(const SpectrumFrame&)>& visit) const;
+
+    // Keeps the first of every run of beats closer than minInterval seconds to the last kept one, beats have to be ascending
+    static void mergeBeats(std::vector<BeatEvent>& beats, const int sampleRate, const float minInterval);
+
+    const OfflineAnalysisConfig& getConfig() const
+    {
+        return config;
+    }
+
+private:
+    // Beats of the analysis frames [firstFrame, endFrame), frame k starts at sample k * hop.
+    // Detection starts a full history earlier, so the detector is in the same state a sequential run would be in.
+    // Returns what forEachFrame returns.
+    uint64_t analyseFrames(AudioSource& source, Stft& stft, const uint64_t firstFrame, const uint64_t endFrame, std::vector<BeatEvent>& beats) const;
+
+    OfflineAnalysisConfig config;
+};
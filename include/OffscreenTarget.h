@@ -0,0 +1,58 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+#include <vector>
+
+// Framebuffer object to render into without a visible window.
+// Frames are read back through a ring of pixel buffer objects, so glReadPixels never waits for the GPU to finish the frame.
+class OffscreenTarget
+{
+public:
+    constexpr static int PBOS = 3;
+
+    OffscreenTarget(const int widthArg, const int heightArg);
+    OffscreenTarget() = delete;
+    OffscreenTarget(const OffscreenTarget& rhs) = delete;
+    OffscreenTarget(OffscreenTarget&& rhs) = delete;
+    OffscreenTarget& operator=(const OffscreenTarget& rhs) = delete;
+    OffscreenTarget& operator=(OffscreenTarget&& rhs) = delete;
+    ~OffscreenTarget();
+
+    void bind() const;
+    void unbind() const;
+
+    // Queues the asynchronous read of the current frame, there has to be a free PBO (pendingFrames() < PBOS)
+    void readback();
+    // Copies the oldest queued frame into pixels (RGBA, bottom row first).
+    // Without wait it returns false if that frame is not finished yet.
+    bool collect(std::vector<unsigned char>& pixels, const bool wait);
+
+    int pendingFrames() const
+    {
+        return pending;
+    }
+    int getWidth() const
+    {
+        return width;
+    }
+    int getHeight() const
+    {
+        return height;
+    }
+
+private:
+    const int width;
+    const int height;
+
+    GLuint FBO{ 0 };
+    GLuint colorRBO{ 0 };
+    GLuint depthRBO{ 0 };
+
+    std::array<GLuint, PBOS> PBO{};
+    std::array<GLsync, PBOS> fences{};
+
+    int writeIndex{ 0 };
+    int pending{ 0 };
+};
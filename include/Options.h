@@ -0,0 +1,39 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+struct Options
+{
+    std::string sound{ "test2.mp3" };
+
+    // Plays a SignalGenerator preset instead of the sound file when set
+    std::string signal;
+    double signalBpm{ 120.0 };
+    double signalSeconds{ 120.0 };
+
+    // Analyses the whole song before playing it and judges presses against the resulting chart
+    bool chart{ false };
+
+    // Tunes the beat detector against the annotated sounds of this folder instead of playing anything
+    std::filesystem::path sweepFolder;
+    std::filesystem::path featureCache;  // features of the sweep are kept here between runs, unless empty
+
+    // Reports beat detection accuracy and analysis speed over synthetic tracks and the annotated sounds of this folder
+    std::filesystem::path evaluationFolder;
+
+    // Analysis frames are written to recordPath as they are produced, or read from replayPath instead of playing anything.
+    // A replay runs at the original pace, with --offscreen it runs on the fixed time step.
+    std::filesystem::path recordPath;
+    std::filesystem::path replayPath;
+
+    // Renders into an FBO of a hidden window at a fixed time step, as fast as the machine allows
+    bool offscreen{ false };
+    int offscreenFrames{ 600 };
+    float offscreenFps{ 60.0f };
+    std::filesystem::path framesOutput;  // raw RGBA frames, bottom row first, nothing is written if empty
+};
+
+// Prints the usage and returns nothing on invalid arguments
+std::optional<Options> parseOptions(const int argc, char* argv[]);
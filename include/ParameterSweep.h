@@ -0,0 +1,34 @@
+#pragma once
+
+#include "BeatDetector.h"
+#include "BeatEvaluation.h"
+#include "FeatureStore.h"
+
+#include <filesystem>
+#include <vector>
+
+// Every combination of these is tried
+struct SweepGrid
+{
+    std::vector<int> histories{ 50, 75, 100, 150, 200 };
+    std::vector<float> varianceSlopes{ -50.0f, -25.714f, -10.0f, 0.0f };
+    std::vector<float> multiplierBases{ 1.2f, 1.3f, 1.4f, 1.5142857f, 1.6f, 1.8f, 2.0f };
+    std::vector<bool> useBands{ false, true };
+};
+
+struct SweepResult
+{
+    BeatDetectorConfig config;
+    DetectionScore score;  // summed over every track
+};
+
+// Beat times in seconds the detector finds in stored features, merged like OfflineAnalyser merges them
+std::vector<double> detectBeats(const TrackFeatures& track, const BeatDetectorConfig& config, const float minBeatInterval);
+
+// Scores every configuration of the grid against the annotations (one list per track of the store) in parallel.
+// Results are sorted by F-measure, best first.
+std::vector<SweepResult> runSweep(
+    const FeatureStore& store, const std::vector<std::vector<double>>& annotations, const SweepGrid& grid, const double tolerance, const float minBeatInterval, int threads = 0);
+
+// The --sweep mode: features of every annotated sound in folder (taken from cache when it matches), then the sweep
+int runSweepTool(const std::filesystem::path& folder, const std::filesystem::path& cache, const OfflineAnalysisConfig& config);
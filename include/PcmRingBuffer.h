@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Keeps the most recent capacity frames of planar PCM.
+// Positions count frames since the first write and never wrap, the storage does.
+class PcmRingBuffer
+{
+public:
+    // Up to two runs of samples, the second one is only used when the range wraps around the end of the storage
+    struct Segments
+    {
+        const float* first{ nullptr };
+        int firstCount{ 0 };
+        const float* second{ nullptr };
+        int secondCount{ 0 };
+    };
+
+    // startPositionArg is the position of the first frame written, to line positions up with an outside clock
+    PcmRingBuffer(const int channelsArg, const int capacityArg, const uint64_t startPositionArg = 0);
+
+    // Interleaved input with getChannels() samples per frame
+    void write(const float* interleaved, const int frames);
+    // Stands in for frames that never arrived, so positions stay in step with the clock
+    void writeSilence(const int frames);
+
+    // The requested range has to lie inside [getOldestPosition(), getWritePosition())
+    Segments read(const int channel, const uint64_t position, const int frames) const;
+
+    int getChannels() const
+    {
+        return channels;
+    }
+    int getCapacity() const
+    {
+        return capacity;
+    }
+    uint64_t getWritePosition() const
+    {
+        return writePosition;
+    }
+    uint64_t getOldestPosition() const
+    {
+        return writePosition - startPosition > uint64_t(capacity) ? writePosition - capacity : startPosition;
+    }
+
+private:
+    const int channels;
+    const int capacity;
+
+    std::vector<float> samples;  // channel after channel, capacity frames each
+    const uint64_t startPosition;
+    uint64_t writePosition;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "SpscQueue.h"
+
+#include "fmod.hpp"
+
+#include <atomic>
+#include <vector>
+
+// One block of interleaved PCM as it went through the mixer
+struct PcmBlock
+{
+    unsigned long long clock{ 0 };  // DSP clock of the first frame
+    int channels{ 0 };
+    int frames{ 0 };
+    std::vector<float> samples;  // preallocated, only the first frames * channels values are valid
+};
+
+// Pass-through FMOD DSP that copies every block the mixer runs through it into a lock-free queue.
+// The mixer thread is the producer, whoever drains the queue is the consumer.
+// Nothing is polled, so no block is ever skipped or seen twice as long as the queue does not fill up.
+class PcmTap
+{
+public:
+    static constexpr int MAX_BLOCK_FRAMES = 1024;  // longer mixer blocks are split
+    static constexpr int MAX_CHANNELS = 8;
+    static constexpr int QUEUE_BLOCKS = 128;  // ~3 seconds of default sized blocks at 44.1 kHz
+
+    PcmTap();
+    ~PcmTap();
+
+    PcmTap(const PcmTap&) = delete;
+    PcmTap& operator=(const PcmTap&) = delete;
+
+    FMOD_RESULT attach(FMOD::System* system, FMOD::Channel* channelArg, const int index);
+    void detach();
+
+    // Consumer side, see SpscQueue
+    const PcmBlock* front()
+    {
+        return queue.front();
+    }
+    void pop()
+    {
+        queue.pop();
+    }
+
+    // Blocks lost to a full queue since the last call
+    unsigned int takeDroppedBlocks()
+    {
+        return dropped.exchange(0);
+    }
+
+private:
+    static FMOD_RESULT F_CALLBACK readCallback(FMOD_DSP_STATE* state, float* inBuffer, float* outBuffer, unsigned int length, int inChannels, int* outChannels);
+
+    void push(const float* samples, const unsigned long long clock, const unsigned int length, const int channels);
+
+    FMOD::DSP* dsp{ nullptr };
+    FMOD::Channel* channel{ nullptr };
+
+    SpscQueue<PcmBlock> queue;
+    std::atomic<unsigned int> dropped{ 0 };
+};
@@ -3,23 +3,79 @@
 #include <glad/glad.h>
 #include "glm.hpp"
 
+#include <cstdint>
 #include <filesystem>
+#include <string>
+#include <vector>
+
+// Handle to an active uniform of a Shader, resolved once after linking.
+// The type parameter makes sure the value set through it has the type the program declares.
+template <typename T>
+struct Uniform
+{
+    int index{ -1 };  // into the uniform table of the shader, -1 if the uniform isn't active
+
+    bool isValid() const
+    {
+        return index >= 0;
+    }
+};
+
+struct ShaderSources
+{
+    std::string vertex;
+    std::string fragment;
+};
 
 class Shader
 {
 public:
     Shader(const std::filesystem::path& vertexPath, const std::filesystem::path& fragmentPath);
+    explicit Shader(const ShaderSources& sources);
+    ~Shader();
+
+    static std::string readSource(const std::filesystem::path& path);
+
+    // Linked programs are stored here keyed by their sources and the driver, and loaded instead of compiling next time.
+    // Caching stays off while this is not set or the driver offers no binary formats.
+    static void setBinaryCacheFolder(const std::filesystem::path& folder);
+
+    // Issues the compile and link of new sources without waiting for the driver.
+    // finishReload() swaps the new program in only if it linked, otherwise the current one stays.
+    void beginReload(const ShaderSources& sources);
+    bool finishReload();
+    bool isReloading() const
+    {
+        return pending.program != 0;
+    }
 
     GLuint getID() const
     {
         return ID;
     }
 
+    // Binding the already bound program is filtered out
     void use() const
     {
-        glUseProgram(ID);
+        if (boundProgram != ID)
+        {
+            glUseProgram(ID);
+            boundProgram = ID;
+        }
     }
 
+    template <typename T>
+    Uniform<T> getUniform(const std::string& name) const;
+
+    // The program has to be bound with use() before setting uniforms
+    void set(const Uniform<bool> uniform, const bool value) const;
+    void set(const Uniform<int> uniform, const int value) const;
+    void set(const Uniform<float> uniform, const float value) const;
+    void set(const Uniform<glm::mat4> uniform, const glm::mat4& mat) const;
+    void set(const Uniform<glm::vec3> uniform, const glm::vec3& vec) const;
+    void set(const Uniform<glm::vec2> uniform, const glm::vec2& vec) const;
+
+    // Looked up by name in the uniform table, prefer the handles in anything called per frame
     void setBool(const std::string& name, const bool value) const;
     void setInt(const std::string& name, const int value) const;
     void setFloat(const std::string& name, const float value) const;
@@ -30,7 +86,47 @@ public:
     void setVec2(const std::string& name, const glm::vec2& vec) const;
 
 private:
+    struct UniformInfo
+    {
+        std::string name;
+        GLint location;
+        GLenum type;
+    };
+
+    struct PendingProgram
+    {
+        GLuint program{ 0 };
+        GLuint vertex{ 0 };
+        GLuint fragment{ 0 };
+
+        std::uint64_t cacheKey{ 0 };  // 0 if the binary cache is off
+        bool fromCache{ false };
+        ShaderSources sources;  // to fall back to when the driver rejects the cached binary
+    };
+
     GLuint ID;
+    std::vector<UniformInfo> uniforms;
+    PendingProgram pending;
+
+    static GLuint boundProgram;
+    static std::filesystem::path binaryCacheFolder;
+
+    static PendingProgram startBuild(const ShaderSources& sources);
+    static PendingProgram compileSources(const ShaderSources& sources, const std::uint64_t cacheKey);
+    static bool finishBuild(PendingProgram& build);
+
+    static bool binaryCacheAvailable();
+    static std::uint64_t binaryCacheKey(const ShaderSources& sources);
+    static std::filesystem::path binaryCachePath(const std::uint64_t key);
+    static GLuint loadBinary(const std::uint64_t key);
+    static void storeBinary(const GLuint program, const std::uint64_t key);
+
+    void resolveUniforms();
+    int findUniform(const std::string& name, const GLenum type) const;
+    GLint location(const int index) const
+    {
+        return index >= 0 ? uniforms[index].location : -1;
+    }
 
     Shader() = delete;
     Shader(const Shader& rhs) = delete;
@@ -38,4 +134,47 @@ private:
 
     Shader& operator=(const Shader& rhs) = delete;
     Shader& operator=(const Shader&& rhs) = delete;
-};
\ No newline at end of file
+};
+
+namespace detail
+{
+template <typename T>
+constexpr GLenum uniformType();
+
+template <>
+constexpr GLenum uniformType<bool>()
+{
+    return GL_BOOL;
+}
+template <>
+constexpr GLenum uniformType<int>()
+{
+    return GL_INT;
+}
+template <>
+constexpr GLenum uniformType<float>()
+{
+    return GL_FLOAT;
+}
+template <>
+constexpr GLenum uniformType<glm::mat4>()
+{
+    return GL_FLOAT_MAT4;
+}
+template <>
+constexpr GLenum uniformType<glm::vec3>()
+{
+    return GL_FLOAT_VEC3;
+}
+template <>
+constexpr GLenum uniformType<glm::vec2>()
+{
+    return GL_FLOAT_VEC2;
+}
+}  // namespace detail
+
+template <typename T>
+Uniform<T> Shader::getUniform(const std::string& name) const
+{
+    return Uniform<T>{ findUniform(name, detail::uniformType<T>()) };
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Shader.h"
+
+#include <atomic>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Owns every shader program of the application.
+// All sources of the shader folder are read once at startup, a background thread watches the folder afterwards
+// and hands changed sources to update(), which rebuilds the affected programs between frames.
+class ShaderManager
+{
+public:
+    ShaderManager(const std::filesystem::path& folderArg);
+    ShaderManager() = delete;
+    ShaderManager(const ShaderManager& rhs) = delete;
+    ShaderManager(ShaderManager&& rhs) = delete;
+    ShaderManager& operator=(const ShaderManager& rhs) = delete;
+    ShaderManager& operator=(ShaderManager&& rhs) = delete;
+    ~ShaderManager();
+
+    // The returned shader lives as long as the manager, reloads swap the program inside it
+    Shader& get(const std::string& vertexName, const std::string& fragmentName);
+
+    // Has to be called on the GL thread, outside of drawing
+    void update();
+
+    // Programs are destroyed with the GL context still current, the watcher thread keeps running
+    void releasePrograms();
+
+private:
+    struct Program
+    {
+        std::string vertexName;
+        std::string fragmentName;
+        std::unique_ptr<Shader> shader;
+    };
+
+    const std::filesystem::path folder;
+
+    std::map<std::string, std::string> sources;
+    std::vector<Program> programs;
+
+    std::thread watcher;
+    std::atomic<bool> running{ true };
+
+    std::mutex changedMutex;
+    std::map<std::string, std::string> changedSources;  // guarded by changedMutex
+
+    void watch();
+    void readChanged(const std::string& name);
+};
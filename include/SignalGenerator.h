@@ -0,0 +1,97 @@
+#pragma once
+
+#include "AudioSource.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+enum class Instrument
+{
+    Click,
+    Kick,
+    Snare,
+    HiHat,
+};
+
+struct DrumHit
+{
+    int step{ 0 };  // sixteenth of the bar, 0 to 15
+    Instrument instrument{ Instrument::Click };
+    float gain{ 1.0f };
+};
+
+struct SignalGeneratorConfig
+{
+    int sampleRate{ 44100 };
+    int channels{ 2 };
+    double seconds{ 60.0 };
+    uint32_t seed{ 1 };
+
+    double bpm{ 120.0 };
+    double firstBeat{ 1.0 };  // seconds before the first bar starts
+    float swing{ 0.0f };      // every second sixteenth is late by this fraction of a sixteenth, 1/3 is a triplet feel
+    std::vector<DrumHit> pattern;  // one bar of 4/4, repeated until the end
+
+    float noise{ 0.0f };  // level of a white noise bed
+    float sweep{ 0.0f };  // level of a logarithmic sine sweep over the whole length
+    float sweepStart{ 20.0f };
+    float sweepEnd{ 20000.0f };
+};
+
+// Test audio computed on demand: drum patterns, noise and sweeps with known beats.
+// Every sample only depends on the config and its frame index, so reads are reproducible in any block size and after any seek.
+class SignalGenerator : public AudioSource
+{
+public:
+    explicit SignalGenerator(const SignalGeneratorConfig& configArg);
+
+    static SignalGeneratorConfig clickTrack(const double bpm, const double seconds);
+    static SignalGeneratorConfig drumLoop(const double bpm, const float swing, const double seconds);
+    // click, drums, swing, noise or sweep, nothing for an unknown name
+    static std::optional<SignalGeneratorConfig> preset(const std::string& name, const double bpm, const double seconds);
+
+    // Quarter notes in seconds, the beats an annotator would tap
+    std::vector<double> getBeats() const;
+    // Start of every hit of the pattern in seconds, ascending
+    std::vector<double> getOnsets() const;
+
+    int getSampleRate() const override
+    {
+        return config.sampleRate;
+    }
+    int getChannels() const override
+    {
+        return config.channels;
+    }
+    uint64_t getLength() const override
+    {
+        return length;
+    }
+
+    int read(float* interleaved, const int frames) override;
+    bool seek(const uint64_t frame) override;
+
+    const SignalGeneratorConfig& getConfig() const
+    {
+        return config;
+    }
+
+private:
+    int64_t hitFrame(const int64_t bar, const DrumHit& hit) const;
+
+    // Adds the hits, the noise bed and the sweep of [position, position + count) to out
+    void render(float* out, const int count) const;
+
+    SignalGeneratorConfig config;
+    uint64_t length{ 0 };
+    uint64_t position{ 0 };
+
+    double sixteenthSeconds{ 0.0 };
+    std::array<std::vector<float>, 4> instruments;  // rendered once, indexed by Instrument
+    size_t longestInstrument{ 0 };
+
+    std::vector<float> mono;
+};
@@ -1,11 +1,11 @@
 #pragma once
 
+#include "Shader.h"
+
 #include <glad/glad.h>
 
 #include <array>
 
-class Shader;
-
 class SpectrogramBar
 {
 public:
@@ -19,6 +19,9 @@ public:
 
     void draw() const;
 
+    // Has to be set before the first bar is drawn
+    static void setShader(Shader& shaderArg);
+
 private:
     float xCoordBottomLeft;  // 0.0-1.0
     float yCoordBottomLeft;  // 0.0-1.0
@@ -32,6 +35,7 @@ private:
     GLuint EBO;
 
     static Shader* shader;
+    static Uniform<bool> isRedUniform;
 
     constexpr static unsigned int indices[] = { 0, 1, 3, 1, 2, 3 };
 };
\ No newline at end of file
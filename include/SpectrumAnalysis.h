@@ -0,0 +1,25 @@
+#pragma once
+
+#include "SpectrumFrame.h"
+
+#include <utility>
+#include <vector>
+
+// Passing a channel index restricts the analysis to that channel of the frame,
+// ALL_CHANNELS sums the results of every channel.
+constexpr int ALL_CHANNELS = -1;
+
+// Buckets receive the summed magnitudes, scaling them for display is up to the Normaliser
+void fillCountsLinear(std::vector<float>& counts, const SpectrumFrame& frame, const int channel = ALL_CHANNELS);
+void fillCountsLog(std::vector<float>& counts, const SpectrumFrame& frame, const int channel = ALL_CHANNELS);
+
+// Lower frequency limits of the buckets fillCountsLog uses, ascending
+std::vector<float> logBucketLimits(const int buckets);
+
+// Representative frequency of every bucket and every bin, to build per frequency stages like MagnitudeScale
+std::vector<float> bucketCentreFrequencies(const int buckets, const int bins, const bool logarithmic);
+std::vector<float> binFrequencies(const int bins);
+
+float calculateSoundEnergy(const SpectrumFrame& frame, const int channel = ALL_CHANNELS);
+float calculateSoundEnergyInBands(const SpectrumFrame& frame, const std::vector<std::pair<float, float>>& bands, const int channel = ALL_CHANNELS);
+float calculateEnergyVariance(const std::vector<float>& energies, const float average);
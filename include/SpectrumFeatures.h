@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Filterbank.h"
+#include "SpectrumAnalysis.h"
+#include "SpectrumFrame.h"
+
+#include <utility>
+#include <vector>
+
+struct SpectrumFeatures
+{
+    std::vector<float> buckets;       // same sums as Filterbank::apply, empty without a filterbank
+    float energy{ 0.0f };             // same as calculateSoundEnergy
+    float bandEnergy{ 0.0f };         // same as calculateSoundEnergyInBands over all bands
+    std::vector<float> bandEnergies;  // every band on its own
+    float centroid{ 0.0f };           // Hz, power weighted mean frequency
+    float rolloff{ 0.0f };            // Hz, rolloffFraction of the power lies below it
+    float flatness{ 0.0f };           // geometric over arithmetic mean of the power, near 0 for tones and near 1 for noise
+};
+
+struct FeatureKernelConfig
+{
+    int bins{ 4096 };
+    float sampleRate{ 44100.0f };
+    std::vector<std::pair<float, float>> bands;
+    float rolloffFraction{ 0.85f };
+};
+
+// Every per frame feature from one pass over each channel's spectrum.
+// The spectrum is walked in chunks small enough to stay in L1, a filterbank row is applied
+// right after the chunk holding its last bin, while its bins are still in cache.
+// Energies and buckets are summed in the same order as the separate functions, so they match them exactly.
+class FeatureKernel
+{
+public:
+    explicit FeatureKernel(const FeatureKernelConfig& configArg, const Filterbank* filterbankArg = nullptr);
+
+    // Overwrites features, returns false for frames with a different bin count than the configuration
+    bool process(const SpectrumFrame& frame, SpectrumFeatures& features, const int channel = ALL_CHANNELS);
+
+    const FeatureKernelConfig& getConfig() const
+    {
+        return config;
+    }
+
+private:
+    struct BinRange
+    {
+        int first{ 0 };
+        int end{ 0 };
+    };
+
+    FeatureKernelConfig config;
+    const Filterbank* filterbank{ nullptr };
+    int chunks{ 0 };
+
+    std::vector<BinRange> bandRanges;
+    std::vector<BinRange> unionRanges;  // bins in any band, ascending and disjoint
+
+    // Rows by the chunk their last bin falls in, chunkRowStart has chunks + 1 offsets into chunkRows
+    std::vector<int> chunkRowStart;
+    std::vector<int> chunkRows;
+
+    std::vector<float> chunkPower;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Magnitude spectrum of one analysis hop.
+// Channels are stored back to back, each one holding bins() values.
+struct SpectrumFrame
+{
+    int numChannels{ 0 };
+    int length{ 0 };  // FFT window size, only the lower half carries information
+    uint64_t samplePosition{ 0 };  // centre of the analysed window, see AudioClock
+
+    std::vector<float> data;
+
+    int bins() const
+    {
+        return length / 2;
+    }
+
+    float* channel(const int index)
+    {
+        return data.data() + size_t(index) * size_t(bins());
+    }
+    const float* channel(const int index) const
+    {
+        return data.data() + size_t(index) * size_t(bins());
+    }
+
+    void resize(const int channels, const int windowSize)
+    {
+        numChannels = channels;
+        length = windowSize;
+        data.resize(size_t(numChannels) * size_t(bins()));
+    }
+};
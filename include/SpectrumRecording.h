@@ -0,0 +1,62 @@
+#pragma once
+
+#include "SpectrumFrame.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+// Analysis frames as the live view saw them, with the resolution they belong to and their sample position.
+// A replay feeds exactly the same data to the rest of the pipeline on every run, whatever the audio device does.
+class SpectrumRecorder
+{
+public:
+    bool open(const std::filesystem::path& path, const int sampleRateArg);
+
+    bool isOpen() const
+    {
+        return file.is_open();
+    }
+
+    void write(const int resolution, const SpectrumFrame& frame);
+
+private:
+    std::ofstream file;
+};
+
+class SpectrumReplay
+{
+public:
+    bool open(const std::filesystem::path& path);
+
+    // Reads the next frame if its sample position is not past until, returns false otherwise
+    bool next(int& resolution, SpectrumFrame& frame, const uint64_t until);
+
+    bool isFinished() const
+    {
+        return !pending;
+    }
+    int getSampleRate() const
+    {
+        return sampleRate;
+    }
+    // Sample position of the first frame, the replay's clock starts there
+    uint64_t getStartPosition() const
+    {
+        return startPosition;
+    }
+
+private:
+    // Header of the next frame, its spectra follow in the file
+    bool readHeader();
+
+    std::ifstream file;
+    int sampleRate{ 0 };
+    uint64_t startPosition{ 0 };
+
+    bool pending{ false };
+    int32_t nextResolution{ 0 };
+    int32_t nextChannels{ 0 };
+    int32_t nextLength{ 0 };
+    uint64_t nextPosition{ 0 };
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Shader.h"
+#include "StreamingBuffer.h"
+
+#include <glad/glad.h>
+
+#include <vector>
+
+// Draws every spectrum bar with one instanced draw call.
+// The vertex shader derives the bar corners from gl_VertexID and gl_InstanceID,
+// the only per frame data are the bar heights and peak markers, streamed into a texture buffer.
+class SpectrumRenderer
+{
+public:
+    SpectrumRenderer(Shader& shaderArg, const int bucketsArg, const float yPos, const float maxHeightArg);
+    SpectrumRenderer() = delete;
+    SpectrumRenderer(const SpectrumRenderer& rhs) = delete;
+    SpectrumRenderer(SpectrumRenderer&& rhs) = delete;
+    SpectrumRenderer& operator=(const SpectrumRenderer& rhs) = delete;
+    SpectrumRenderer& operator=(SpectrumRenderer&& rhs) = delete;
+    ~SpectrumRenderer();
+
+    // heights and peaks are 0.0-1.0, one per bucket, no markers are drawn without peaks
+    void update(const std::vector<float>& heights, const std::vector<float>& peaks = {});
+    void draw();
+
+private:
+    const int buckets;
+    const float yCoordBottom;  // 0.0-1.0
+    const float maxHeight;     // 0.0-1.0
+
+    Shader& shader;
+    Uniform<int> heightsUniform;
+    Uniform<int> firstHeightUniform;
+    Uniform<int> bucketsUniform;
+    Uniform<float> baseYUniform;
+    Uniform<float> maxHeightUniform;
+    Uniform<float> redThresholdUniform;
+
+    StreamingBuffer heightBuffer;
+    GLintptr heightOffset{ 0 };
+    bool drawPeaks{ false };
+
+    GLuint heightTexture{ 0 };
+    GLuint VAO{ 0 };
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// Slots are constructed up front and reused, so neither side allocates once the queue exists.
+template<typename T>
+class SpscQueue
+{
+public:
+    // Capacity is rounded up to a power of two
+    explicit SpscQueue(const size_t capacityArg)
+        : slots(roundUp(capacityArg))
+        , mask(slots.size() - 1)
+    {
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side. beginPush hands out the next free slot to fill in place, or nullptr when the queue is full.
+    T* beginPush()
+    {
+        const size_t tail = writeIndex.load(std::memory_order_relaxed);
+        if (tail - readIndex.load(std::memory_order_acquire) == slots.size())
+        {
+            return nullptr;
+        }
+        return &slots[tail & mask];
+    }
+    void endPush()
+    {
+        writeIndex.store(writeIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    bool tryPush(const T& value)
+    {
+        T* slot = beginPush();
+        if (slot == nullptr)
+        {
+            return false;
+        }
+        *slot = value;
+        endPush();
+        return true;
+    }
+
+    // Consumer side. front is the oldest element or nullptr when the queue is empty, pop releases it.
+    T* front()
+    {
+        const size_t head = readIndex.load(std::memory_order_relaxed);
+        if (head == writeIndex.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+        return &slots[head & mask];
+    }
+    void pop()
+    {
+        readIndex.store(readIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    bool tryPop(T& value)
+    {
+        T* slot = front();
+        if (slot == nullptr)
+        {
+            return false;
+        }
+        value = *slot;
+        pop();
+        return true;
+    }
+
+    // Only exact when called from either end with the other one idle
+    size_t size() const
+    {
+        return writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire);
+    }
+    size_t capacity() const
+    {
+        return slots.size();
+    }
+
+    // Gives every slot a chance to preallocate, before any thread uses the queue
+    template<typename Function>
+    void forEachSlot(Function&& function)
+    {
+        for (T& slot : slots)
+        {
+            function(slot);
+        }
+    }
+
+private:
+    static size_t roundUp(const size_t value)
+    {
+        size_t ret = 1;
+        while (ret < value)
+        {
+            ret <<= 1;
+        }
+        return ret;
+    }
+
+    std::vector<T> slots;
+    const size_t mask;
+
+    // Separate cache lines, so the two threads do not keep invalidating each other
+    alignas(64) std::atomic<size_t> writeIndex{ 0 };
+    alignas(64) std::atomic<size_t> readIndex{ 0 };
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "SpectrumFrame.h"
+
+#include "fftw3.h"
+
+#include <cstdint>
+#include <vector>
+
+class PcmRingBuffer;
+
+enum class WindowFunction
+{
+    Hann,
+    BlackmanHarris,  // 4 term, lower side lobes for a wider main lobe
+};
+
+struct StftConfig
+{
+    int windowSize{ 8192 };
+    int hop{ 1024 };
+    WindowFunction window{ WindowFunction::Hann };
+};
+
+// Short-time Fourier transform over the PCM collected in a PcmRingBuffer.
+// Each hop windows the samples straight out of the ring into the FFT input, wrap around included,
+// and writes magnitudes scaled so a full scale sine peaks at about 1.
+class Stft
+{
+public:
+    explicit Stft(const StftConfig& configArg = StftConfig{});
+    ~Stft();
+
+    Stft(const Stft&) = delete;
+    Stft& operator=(const Stft&) = delete;
+
+    // Produces the next frame once the ring holds enough samples for it, returns false otherwise.
+    // Frames the ring has already overwritten are skipped.
+    bool next(const PcmRingBuffer& ring, SpectrumFrame& frame);
+    bool isReady(const PcmRingBuffer& ring) const;
+
+    // Position of the first sample of the next frame
+    uint64_t getPosition() const
+    {
+        return position;
+    }
+    void setPosition(const uint64_t positionArg)
+    {
+        position = positionArg;
+    }
+
+    const StftConfig& getConfig() const
+    {
+        return config;
+    }
+
+    // Where the next frame starts, after skipping whatever the ring no longer holds
+    uint64_t getNextStart(const PcmRingBuffer& ring) const;
+
+    static std::vector<float> makeWindow(const WindowFunction function, const int size);
+
+private:
+    StftConfig config;
+    std::vector<float> window;
+    float magnitudeScale;
+
+    double* input{ nullptr };
+    fftw_complex* output{ nullptr };
+    fftw_plan plan{ nullptr };
+
+    uint64_t position{ 0 };
+};
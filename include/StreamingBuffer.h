@@ -0,0 +1,53 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+
+// Ring of REGIONS equally sized regions in one GL buffer, each guarded by a fence.
+// The CPU writes region N while the GPU may still read regions N-1 and N-2, so uploads never wait on the driver.
+// Uses a persistently mapped buffer where GL 4.4 is available, unsynchronized range mapping of a GL_STREAM_DRAW buffer otherwise.
+class StreamingBuffer
+{
+public:
+    constexpr static int REGIONS = 3;
+
+    StreamingBuffer(const GLenum targetArg, const GLsizeiptr regionSizeArg, const GLsizeiptr alignment = 1);
+    StreamingBuffer() = delete;
+    StreamingBuffer(const StreamingBuffer& rhs) = delete;
+    StreamingBuffer(StreamingBuffer&& rhs) = delete;
+    StreamingBuffer& operator=(const StreamingBuffer& rhs) = delete;
+    StreamingBuffer& operator=(StreamingBuffer&& rhs) = delete;
+    ~StreamingBuffer();
+
+    // Returns the write pointer of the next region, blocks only if the GPU is still three frames behind
+    void* beginWrite();
+    // Returns the byte offset of the region that was just written
+    GLintptr endWrite();
+    // Has to be called after the draw call reading the last written region has been issued
+    void fence();
+
+    GLuint getID() const
+    {
+        return ID;
+    }
+    GLenum getTarget() const
+    {
+        return target;
+    }
+    GLintptr getOffset() const
+    {
+        return GLintptr(region) * regionStride;
+    }
+
+private:
+    const GLenum target;
+    const GLsizeiptr regionSize;
+    GLsizeiptr regionStride;
+
+    GLuint ID{ 0 };
+    int region{ 0 };
+    void* persistentPtr{ nullptr };
+
+    std::array<GLsync, REGIONS> fences{};
+};
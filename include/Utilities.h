@@ -6,4 +6,6 @@ std::filesystem::path getShaderFolderPath();
 std::filesystem::path getShaderPath(const std::string& shaderName);
 
 std::filesystem::path getSoundsFolderPath();
-std::filesystem::path getSoundPath(const std::string& soundName);
\ No newline at end of file
+std::filesystem::path getSoundPath(const std::string& soundName);
+
+std::filesystem::path getCacheFolderPath();
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Shader.h"
+
+#include <glad/glad.h>
+
+#include <vector>
+
+// Scrolling spectrogram. Every update writes one column of buckets into a row of a ring texture,
+// the shader scrolls through the ring with a texture coordinate offset, so history is never redrawn.
+class WaterfallView
+{
+public:
+    WaterfallView(Shader& shaderArg, const int bucketsArg, const int historyRowsArg, const float xPos, const float yPos, const float widthArg, const float heightArg);
+    WaterfallView() = delete;
+    WaterfallView(const WaterfallView& rhs) = delete;
+    WaterfallView(WaterfallView&& rhs) = delete;
+    WaterfallView& operator=(const WaterfallView& rhs) = delete;
+    WaterfallView& operator=(WaterfallView&& rhs) = delete;
+    ~WaterfallView();
+
+    // values are 0.0-1.0, one per bucket
+    void update(const std::vector<float>& values);
+    void draw();
+
+private:
+    const int buckets;
+    const int historyRows;
+
+    float xCoordBottomLeft;  // 0.0-1.0
+    float yCoordBottomLeft;  // 0.0-1.0
+    float width;             // 0.0-1.0
+    float height;            // 0.0-1.0
+
+    Shader& shader;
+    Uniform<glm::vec2> originUniform;
+    Uniform<glm::vec2> sizeUniform;
+    Uniform<int> historyUniform;
+    Uniform<float> rowOffsetUniform;
+
+    GLuint texture{ 0 };
+    GLuint VAO{ 0 };
+
+    int newestRow{ -1 };
+};
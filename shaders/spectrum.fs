@@ -0,0 +1,24 @@
+#version 330 core
+
+uniform float redThreshold;
+
+flat in float barHeight;
+flat in int isPeak;
+
+out vec4 FragColor;
+
+void main()
+{
+    if (isPeak != 0)
+    {
+        FragColor = vec4(1.0f, 1.0f, 1.0f, 1.0f);
+    }
+    else if (barHeight > redThreshold)
+    {
+        FragColor = vec4(1.0f, 0.0f, 0.0f, 1.0f);
+    }
+    else
+    {
+        FragColor = vec4(1.0f, 1.0f, 0.0f, 1.0f);
+    }
+}
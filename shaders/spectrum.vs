@@ -0,0 +1,31 @@
+#version 330 core
+
+// One instance per bar followed by one instance per peak marker, four vertices per instance drawn as a triangle strip
+uniform samplerBuffer heights;  // 0.0-1.0 per bucket, bar heights then peaks
+uniform int firstHeight;        // index of the first bucket of the current frame in heights
+uniform int buckets;
+uniform float baseY;
+uniform float maxHeight;
+
+const float PEAK_THICKNESS = 0.005f;
+
+flat out float barHeight;
+flat out int isPeak;
+
+void main()
+{
+	vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+
+	int bar = gl_InstanceID % buckets;
+	isPeak = gl_InstanceID / buckets;
+
+	float left = (float(bar) + 0.25f) / float(buckets);
+	float width = 0.5f / float(buckets);
+	barHeight = texelFetch(heights, firstHeight + gl_InstanceID).r * maxHeight;
+
+	float bottom = isPeak != 0 ? baseY + barHeight : baseY;
+	float height = isPeak != 0 ? PEAK_THICKNESS : barHeight;
+
+	vec2 pos = vec2(left + corner.x * width, bottom + corner.y * height);
+	gl_Position = vec4(pos * 2.0f - 1.0f, 0.0f, 1.0f);
+}
@@ -0,0 +1,16 @@
+#version 330 core
+
+uniform sampler2D history;
+uniform float rowOffset;
+
+in vec2 uv;
+
+out vec4 FragColor;
+
+void main()
+{
+    float value = clamp(texture(history, vec2(uv.x, uv.y + rowOffset)).r, 0.0f, 1.0f);
+
+    // black -> red -> yellow, same colours as the bars
+    FragColor = vec4(min(value * 2.0f, 1.0f), max(value * 2.0f - 1.0f, 0.0f), 0.0f, 1.0f);
+}
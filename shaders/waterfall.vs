@@ -0,0 +1,14 @@
+#version 330 core
+
+uniform vec2 origin;  // bottom left corner, 0.0-1.0
+uniform vec2 size;    // 0.0-1.0
+
+out vec2 uv;
+
+void main()
+{
+	uv = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+
+	vec2 pos = origin + uv * size;
+	gl_Position = vec4(pos * 2.0f - 1.0f, 0.0f, 1.0f);
+}
@@ -0,0 +1,55 @@
+#include "AudioClock.h"
+
+#include <cmath>
+
+namespace
+{
+constexpr double SLEW = 0.05;            // share of the error corrected per observation
+constexpr double RESYNC_SECONDS = 0.1;  // errors above this are taken as a discontinuity
+}  // namespace
+
+AudioClock::AudioClock(const int sampleRateArg)
+    : sampleRate(sampleRateArg)
+{
+}
+
+void AudioClock::sync(const uint64_t samplePosition, const std::chrono::steady_clock::time_point time)
+{
+    if (!synced)
+    {
+        anchorPosition = samplePosition;
+        anchorTime = time;
+        lastObserved = samplePosition;
+        synced = true;
+        return;
+    }
+
+    // The observed clock only moves a block at a time, it is accurate right when it moved
+    if (samplePosition == lastObserved)
+    {
+        return;
+    }
+    lastObserved = samplePosition;
+
+    const double error = std::chrono::duration<double>(time - toTime(samplePosition)).count();
+
+    // Moving the anchor along keeps the differences small, so double precision never becomes a concern
+    anchorTime = toTime(samplePosition);
+    anchorPosition = samplePosition;
+
+    const double correction = std::abs(error) > RESYNC_SECONDS ? error : error * SLEW;
+    anchorTime += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(correction));
+}
+
+std::chrono::steady_clock::time_point AudioClock::toTime(const uint64_t samplePosition) const
+{
+    const double seconds = secondsBetween(anchorPosition, samplePosition);
+    return anchorTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+}
+
+uint64_t AudioClock::toSamples(const std::chrono::steady_clock::time_point time) const
+{
+    const double seconds = std::chrono::duration<double>(time - anchorTime).count();
+    const double position = double(anchorPosition) + seconds * sampleRate;
+    return position > 0.0 ? uint64_t(std::llround(position)) : 0;
+}
@@ -0,0 +1,82 @@
+#include "BarSmoother.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define BAR_SMOOTHER_SSE
+#include <emmintrin.h>
+#endif
+
+BarSmoother::BarSmoother(const int bucketsArg, const SmoothingConfig& configArg)
+    : buckets(bucketsArg)
+    , config(configArg)
+    , values(bucketsArg, 0.0f)
+    , peaks(bucketsArg, 0.0f)
+    , peakAges(bucketsArg, 0.0f)
+{
+}
+
+void BarSmoother::update(const std::vector<float>& targets, const float dt)
+{
+    if (dt <= 0.0f)
+    {
+        return;
+    }
+
+    const int count = std::min(int(targets.size()), buckets);
+
+    const float attack = 1.0f - std::exp(-dt / config.attackTime);
+    const float release = 1.0f - std::exp(-dt / config.releaseTime);
+    const float fall = config.peakFallSpeed * dt;
+    const float hold = config.peakHoldTime;
+
+    const float* target = targets.data();
+    float* value = values.data();
+    float* peak = peaks.data();
+    float* age = peakAges.data();
+
+    int i = 0;
+
+#if defined(BAR_SMOOTHER_SSE)
+    const __m128 attackV = _mm_set1_ps(attack);
+    const __m128 releaseV = _mm_set1_ps(release);
+    const __m128 fallV = _mm_set1_ps(fall);
+    const __m128 holdV = _mm_set1_ps(hold);
+    const __m128 dtV = _mm_set1_ps(dt);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 t = _mm_loadu_ps(target + i);
+        const __m128 previous = _mm_loadu_ps(value + i);
+
+        const __m128 rising = _mm_cmpgt_ps(t, previous);
+        const __m128 coefficient = _mm_or_ps(_mm_and_ps(rising, attackV), _mm_andnot_ps(rising, releaseV));
+        const __m128 v = _mm_add_ps(previous, _mm_mul_ps(_mm_sub_ps(t, previous), coefficient));
+
+        const __m128 p = _mm_loadu_ps(peak + i);
+        const __m128 pushed = _mm_cmpge_ps(v, p);
+        const __m128 a = _mm_andnot_ps(pushed, _mm_add_ps(_mm_loadu_ps(age + i), dtV));
+        const __m128 falling = _mm_sub_ps(p, _mm_and_ps(_mm_cmpgt_ps(a, holdV), fallV));
+
+        _mm_storeu_ps(value + i, v);
+        _mm_storeu_ps(age + i, a);
+        _mm_storeu_ps(peak + i, _mm_max_ps(falling, v));
+    }
+#endif
+
+    // Same as the SIMD loop, for the remainder and for targets without SSE
+    for (; i < count; ++i)
+    {
+        const float coefficient = target[i] > value[i] ? attack : release;
+        const float v = value[i] + (target[i] - value[i]) * coefficient;
+
+        const bool pushed = v >= peak[i];
+        const float a = pushed ? 0.0f : age[i] + dt;
+        const float falling = a > hold ? peak[i] - fall : peak[i];
+
+        value[i] = v;
+        age[i] = a;
+        peak[i] = std::max(falling, v);
+    }
+}
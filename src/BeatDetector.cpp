@@ -0,0 +1,46 @@
+#include "BeatDetector.h"
+
+#include "SpectrumAnalysis.h"
+
+#include <algorithm>
+#include <numeric>
+
+BeatDetector::BeatDetector(const BeatDetectorConfig& configArg)
+    : config(configArg)
+    , memory(size_t(std::max(configArg.history, 1)), 0.0f)
+{
+}
+
+void BeatDetector::reset()
+{
+    std::fill(memory.begin(), memory.end(), 0.0f);
+    memoryPtr = 0;
+    lastMultiplier = 0.0f;
+}
+
+std::optional<BeatEvent> BeatDetector::process(const SpectrumFrame& frame)
+{
+    const float energy = config.useBands ? calculateSoundEnergyInBands(frame, config.bands) : calculateSoundEnergy(frame);
+    return process(energy, frame.samplePosition);
+}
+
+std::optional<BeatEvent> BeatDetector::process(const float energy, const uint64_t samplePosition)
+{
+    const float previousEnergies = std::accumulate(memory.begin(), memory.end(), 0.0f);
+    const float averageEnergy = (1 / float(memory.size())) * previousEnergies;
+    const float variance = calculateEnergyVariance(memory, averageEnergy);
+
+    memory[memoryPtr++] = energy;
+    if (memoryPtr == memory.size())
+    {
+        memoryPtr = 0;
+    }
+
+    lastMultiplier = config.varianceSlope * variance + config.multiplierBase;
+
+    if (energy > lastMultiplier * averageEnergy)
+    {
+        return BeatEvent{ samplePosition, energy };
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,123 @@
+#include "BeatEvaluation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+float DetectionScore::precision() const
+{
+    const int detections = truePositives + falsePositives;
+    return detections > 0 ? float(truePositives) / detections : 0.0f;
+}
+
+float DetectionScore::recall() const
+{
+    const int annotations = truePositives + falseNegatives;
+    return annotations > 0 ? float(truePositives) / annotations : 0.0f;
+}
+
+float DetectionScore::fMeasure() const
+{
+    const int total = 2 * truePositives + falsePositives + falseNegatives;
+    return total > 0 ? 2.0f * truePositives / total : 0.0f;
+}
+
+DetectionScore& DetectionScore::operator+=(const DetectionScore& other)
+{
+    truePositives += other.truePositives;
+    falsePositives += other.falsePositives;
+    falseNegatives += other.falseNegatives;
+    return *this;
+}
+
+DetectionScore scoreBeats(const std::vector<double>& detected, const std::vector<double>& annotated, const double tolerance)
+{
+    DetectionScore ret;
+
+    // Both lists are sorted, so walking them side by side pairs every annotation with the earliest detection close enough to it
+    size_t d = 0;
+    for (const double annotation : annotated)
+    {
+        while (d < detected.size() && detected[d] < annotation - tolerance)
+        {
+            ++ret.falsePositives;
+            ++d;
+        }
+
+        if (d < detected.size() && std::abs(detected[d] - annotation) <= tolerance)
+        {
+            ++ret.truePositives;
+            ++d;
+        }
+        else
+        {
+            ++ret.falseNegatives;
+        }
+    }
+    ret.falsePositives += int(detected.size() - d);
+
+    return ret;
+}
+
+std::vector<double> loadAnnotations(const std::filesystem::path& path)
+{
+    std::vector<double> ret;
+
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream stream(line);
+        double time;
+        if (stream >> time)
+        {
+            ret.push_back(time);
+        }
+    }
+
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+std::filesystem::path findAnnotations(const std::filesystem::path& audioPath)
+{
+    for (const char* extension : { ".beats", ".txt" })
+    {
+        std::filesystem::path candidate = audioPath;
+        candidate.replace_extension(extension);
+        if (std::filesystem::exists(candidate))
+        {
+            return candidate;
+        }
+    }
+
+    return {};
+}
+
+bool isAudioFile(const std::filesystem::path& path)
+{
+    const std::string extension = path.extension().string();
+    return extension == ".mp3" || extension == ".wav" || extension == ".ogg" || extension == ".flac";
+}
+
+std::vector<std::filesystem::path> findAnnotatedSounds(const std::filesystem::path& folder)
+{
+    std::vector<std::filesystem::path> ret;
+    if (!std::filesystem::is_directory(folder))
+    {
+        return ret;
+    }
+
+    for (const auto& entry : std::filesystem::directory_iterator(folder))
+    {
+        if (entry.is_regular_file() && isAudioFile(entry.path()) && !findAnnotations(entry.path()).empty())
+        {
+            ret.push_back(entry.path());
+        }
+    }
+
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
@@ -0,0 +1,132 @@
+#include "ChannelMixer.h"
+
+#include "fmod.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+ChannelMixer::ChannelMixer(const ChannelLayout layoutArg)
+    : layout(layoutArg)
+{
+}
+
+int ChannelMixer::outputChannels(const ChannelLayout layout, const int inputChannels)
+{
+    switch (layout)
+    {
+        case ChannelLayout::Mono:
+            return inputChannels > 0 ? 1 : 0;
+        case ChannelLayout::MidSide:
+            return inputChannels > 0 ? 2 : 0;
+        case ChannelLayout::PerChannel:
+            return inputChannels;
+    }
+
+    return inputChannels;
+}
+
+void ChannelMixer::process(const FMOD_DSP_PARAMETER_FFT* fftData, SpectrumFrame& frame) const
+{
+    frame.resize(outputChannels(layout, fftData->numchannels), fftData->length);
+
+    const int bins = frame.bins();
+    if (frame.numChannels == 0 || bins == 0)
+    {
+        return;
+    }
+
+    switch (layout)
+    {
+        case ChannelLayout::Mono:
+        {
+            float* out = frame.channel(0);
+            std::copy(fftData->spectrum[0], fftData->spectrum[0] + bins, out);
+
+            for (int channel = 1; channel < fftData->numchannels; ++channel)
+            {
+                const float* in = fftData->spectrum[channel];
+                for (int i = 0; i < bins; ++i)
+                {
+                    out[i] += in[i];
+                }
+            }
+
+            const float scale = 1.0f / fftData->numchannels;
+            for (int i = 0; i < bins; ++i)
+            {
+                out[i] *= scale;
+            }
+            break;
+        }
+        case ChannelLayout::MidSide:
+        {
+            // FMOD only hands out magnitudes, so this is the magnitude domain approximation of mid/side
+            const float* left = fftData->spectrum[0];
+            const float* right = fftData->numchannels > 1 ? fftData->spectrum[1] : fftData->spectrum[0];
+
+            float* mid = frame.channel(0);
+            float* side = frame.channel(1);
+            for (int i = 0; i < bins; ++i)
+            {
+                mid[i] = (left[i] + right[i]) * 0.5f;
+                side[i] = std::abs(left[i] - right[i]) * 0.5f;
+            }
+            break;
+        }
+        case ChannelLayout::PerChannel:
+        {
+            for (int channel = 0; channel < fftData->numchannels; ++channel)
+            {
+                std::copy(fftData->spectrum[channel], fftData->spectrum[channel] + bins, frame.channel(channel));
+            }
+            break;
+        }
+    }
+}
+
+void ChannelMixer::process(const float* interleaved, const int inputChannels, const int frames, std::vector<float>& out) const
+{
+    const int channels = outputChannels(layout, inputChannels);
+    out.resize(size_t(channels) * size_t(frames));
+
+    if (channels == 0)
+    {
+        return;
+    }
+
+    switch (layout)
+    {
+        case ChannelLayout::Mono:
+        {
+            const float scale = 1.0f / inputChannels;
+            for (int i = 0; i < frames; ++i)
+            {
+                const float* in = interleaved + size_t(i) * size_t(inputChannels);
+
+                float sum{ 0.0f };
+                for (int channel = 0; channel < inputChannels; ++channel)
+                {
+                    sum += in[channel];
+                }
+                out[i] = sum * scale;
+            }
+            break;
+        }
+        case ChannelLayout::MidSide:
+        {
+            const int rightChannel = inputChannels > 1 ? 1 : 0;
+            for (int i = 0; i < frames; ++i)
+            {
+                const float* in = interleaved + size_t(i) * size_t(inputChannels);
+                out[2 * size_t(i)] = (in[0] + in[rightChannel]) * 0.5f;
+                out[2 * size_t(i) + 1] = (in[0] - in[rightChannel]) * 0.5f;
+            }
+            break;
+        }
+        case ChannelLayout::PerChannel:
+        {
+            std::copy(interleaved, interleaved + out.size(), out.begin());
+            break;
+        }
+    }
+}
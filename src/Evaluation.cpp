@@ -0,0 +1,193 @@
+#include "Evaluation.h"
+
+#include "AudioSource.h"
+#include "FileAudioSource.h"
+#include "SignalGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+namespace
+{
+constexpr double SYNTHETIC_SECONDS = 30.0;
+
+void printResult(const EvaluationResult& result)
+{
+    std::cout << std::left << std::setw(32) << result.name << std::right << std::fixed << std::setprecision(3) << " F " << result.score.fMeasure() << " P "
+              << result.score.precision() << " R " << result.score.recall() << std::setprecision(1) << " | " << std::setw(5) << result.beats << " beats, "
+              << std::setw(7) << result.realTime() << "x real time\n";
+}
+}  // namespace
+
+double EvaluationResult::realTime() const
+{
+    return analysisSeconds > 0.0 ? audioSeconds / analysisSeconds : 0.0;
+}
+
+EvaluationResult evaluateSource(AudioSource& source, const std::vector<double>& annotations, const OfflineAnalyser& analyser, const std::string& name,
+    const double tolerance, Chart* analysed)
+{
+    EvaluationResult ret;
+    ret.name = name;
+
+    const auto start = std::chrono::steady_clock::now();
+    const Chart chart = analyser.analyse(source);
+    ret.analysisSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (analysed)
+    {
+        *analysed = chart;
+    }
+
+    if (chart.sampleRate <= 0)
+    {
+        return ret;
+    }
+
+    std::vector<double> detected;
+    detected.reserve(chart.beats.size());
+    for (const BeatEvent& beat : chart.beats)
+    {
+        detected.push_back(double(beat.samplePosition) / chart.sampleRate);
+    }
+
+    ret.score = scoreBeats(detected, annotations, tolerance);
+    ret.beats = int(detected.size());
+    ret.audioSeconds = double(chart.length) / chart.sampleRate;
+
+    return ret;
+}
+
+bool compareParallel(const Chart& sequential, const Chart& parallel, const std::string& name)
+{
+    if (sequential.sampleRate != parallel.sampleRate || sequential.length != parallel.length)
+    {
+        std::cout << "ERROR::EVALUATION::PARALLEL_MISMATCH " << name << ": sample rate " << parallel.sampleRate << ", length " << parallel.length
+                  << " instead of " << sequential.sampleRate << ", " << sequential.length << "\n";
+        return false;
+    }
+
+    const size_t count = std::min(sequential.beats.size(), parallel.beats.size());
+    for (size_t i = 0; i < count; ++i)
+    {
+        const BeatEvent& expected = sequential.beats[i];
+        const BeatEvent& actual = parallel.beats[i];
+        if (expected.samplePosition != actual.samplePosition || expected.energy != actual.energy)
+        {
+            std::cout << "ERROR::EVALUATION::PARALLEL_MISMATCH " << name << ": beat " << i << " at " << actual.samplePosition << " with energy " << actual.energy
+                      << " instead of " << expected.samplePosition << " with " << expected.energy << "\n";
+            return false;
+        }
+    }
+
+    if (sequential.beats.size() != parallel.beats.size())
+    {
+        std::cout << "ERROR::EVALUATION::PARALLEL_MISMATCH " << name << ": " << parallel.beats.size() << " beats instead of " << sequential.beats.size() << "\n";
+        return false;
+    }
+
+    return true;
+}
+
+std::vector<EvaluationResult> evaluateSynthetic(const OfflineAnalyser& analyser, const double tolerance)
+{
+    struct Track
+    {
+        const char* name;
+        SignalGeneratorConfig config;
+    };
+
+    SignalGeneratorConfig noisyClicks = SignalGenerator::clickTrack(120.0, SYNTHETIC_SECONDS);
+    noisyClicks.noise = 0.05f;
+    SignalGeneratorConfig noisyDrums = SignalGenerator::drumLoop(150.0, 0.0f, SYNTHETIC_SECONDS);
+    noisyDrums.noise = 0.2f;
+
+    const Track tracks[] = {
+        { "clicks 90 bpm", SignalGenerator::clickTrack(90.0, SYNTHETIC_SECONDS) },
+        { "clicks 120 bpm", SignalGenerator::clickTrack(120.0, SYNTHETIC_SECONDS) },
+        { "clicks 174 bpm", SignalGenerator::clickTrack(174.0, SYNTHETIC_SECONDS) },
+        { "clicks 120 bpm, noise", noisyClicks },
+        { "drums 120 bpm", SignalGenerator::drumLoop(120.0, 0.0f, SYNTHETIC_SECONDS) },
+        { "drums 100 bpm, swing", SignalGenerator::drumLoop(100.0, 1.0f / 3.0f, SYNTHETIC_SECONDS) },
+        { "drums 150 bpm, loud noise", noisyDrums },
+    };
+
+    std::vector<EvaluationResult> ret;
+    for (const Track& track : tracks)
+    {
+        SignalGenerator source(track.config);
+        ret.push_back(evaluateSource(source, source.getBeats(), analyser, track.name, tolerance));
+    }
+
+    return ret;
+}
+
+int runEvaluationTool(const std::filesystem::path& folder, const OfflineAnalysisConfig& config)
+{
+    const OfflineAnalyser analyser(config);
+
+    std::vector<EvaluationResult> results = evaluateSynthetic(analyser);
+
+    const std::vector<std::filesystem::path> sounds = findAnnotatedSounds(folder);
+    if (!std::filesystem::is_directory(folder))
+    {
+        std::cout << "No folder " << folder << ", evaluating the synthetic tracks only\n";
+    }
+
+    int mismatches = 0;
+    if (!sounds.empty())
+    {
+        FMOD::System* system = FileAudioSource::createDecodingSystem();
+        if (!system)
+        {
+            return -1;
+        }
+
+        for (const std::filesystem::path& sound : sounds)
+        {
+            FileAudioSource source(system, sound.string());
+            if (!source.isOpen())
+            {
+                continue;
+            }
+
+            Chart sequential;
+            results.push_back(evaluateSource(source, loadAnnotations(findAnnotations(sound)), analyser, sound.filename().string(), 0.07, &sequential));
+
+            const Chart parallel = analyser.analyseParallel([&]() {
+                auto opened = std::make_unique<FileAudioSource>(system, sound.string());
+                return opened->isOpen() ? std::unique_ptr<AudioSource>(std::move(opened)) : nullptr;
+            });
+            if (!compareParallel(sequential, parallel, sound.filename().string()))
+            {
+                ++mismatches;
+            }
+        }
+
+        system->release();
+    }
+
+    EvaluationResult total;
+    total.name = "total";
+    for (const EvaluationResult& result : results)
+    {
+        printResult(result);
+
+        total.score += result.score;
+        total.beats += result.beats;
+        total.audioSeconds += result.audioSeconds;
+        total.analysisSeconds += result.analysisSeconds;
+    }
+    printResult(total);
+
+    if (mismatches > 0)
+    {
+        std::cout << mismatches << " of " << sounds.size() << " sound(s) analysed differently in parallel\n";
+        return -1;
+    }
+
+    return 0;
+}
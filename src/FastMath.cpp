@@ -0,0 +1,69 @@
+#include "FastMath.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define FAST_MATH_SSE
+#include <emmintrin.h>
+#endif
+
+void fastDecibels(float* values, const int count, const float minimum)
+{
+    int i = 0;
+
+#if defined(FAST_MATH_SSE)
+    const __m128 minimumV = _mm_set1_ps(minimum);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 toDecibels = _mm_set1_ps(6.0205999132796239f);
+    const __m128i mantissaMask = _mm_set1_epi32(0x007fffff);
+    const __m128i exponentOne = _mm_set1_epi32(0x3f800000);
+    const __m128i bias = _mm_set1_epi32(127);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i bits = _mm_castps_si128(_mm_max_ps(_mm_loadu_ps(values + i), minimumV));
+
+        const __m128 exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), bias));
+        const __m128 mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, mantissaMask), exponentOne));
+
+        __m128 poly = _mm_set1_ps(0.059651548267457497f);
+        poly = _mm_add_ps(_mm_mul_ps(poly, mantissa), _mm_set1_ps(-0.46572564428884478f));
+        poly = _mm_add_ps(_mm_mul_ps(poly, mantissa), _mm_set1_ps(1.4811664752121317f));
+        poly = _mm_add_ps(_mm_mul_ps(poly, mantissa), _mm_set1_ps(-2.5207496257780700f));
+        poly = _mm_add_ps(_mm_mul_ps(poly, mantissa), _mm_set1_ps(2.8882704548164776f));
+
+        const __m128 log2 = _mm_add_ps(exponent, _mm_mul_ps(poly, _mm_sub_ps(mantissa, one)));
+        _mm_storeu_ps(values + i, _mm_mul_ps(log2, toDecibels));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        values[i] = fastDecibels(std::max(values[i], minimum));
+    }
+}
+
+float dotProduct(const float* a, const float* b, const int count)
+{
+    int i = 0;
+    float sum{ 0.0f };
+
+#if defined(FAST_MATH_SSE)
+    __m128 acc = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4)
+    {
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+
+    for (; i < count; ++i)
+    {
+        sum += a[i] * b[i];
+    }
+
+    return sum;
+}
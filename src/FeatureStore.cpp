@@ -0,0 +1,205 @@
+#include "FeatureStore.h"
+
+#include "AudioSource.h"
+#include "BinaryIO.h"
+#include "SpectrumFeatures.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+constexpr char MAGIC[4] = { 'B', 'F', 'S', '2' };
+
+// Smallest track in the file: name length, file size, file time, sample rate, hop, window size and frame count
+constexpr uint64_t TRACK_HEADER_BYTES = 4 + 8 + 8 + 4 + 4 + 4 + 8;
+constexpr uint32_t MAX_NAME_LENGTH = 4096;
+
+// The parts of the analysis config the stored values depend on
+std::vector<float> settingsOf(const OfflineAnalysisConfig& config)
+{
+    std::vector<float> ret{ float(config.layout), float(config.stft.windowSize), float(config.stft.hop), float(config.stft.window) };
+    for (const auto& band : config.detector.bands)
+    {
+        ret.push_back(band.first);
+        ret.push_back(band.second);
+    }
+    return ret;
+}
+}  // namespace
+
+void TrackFeatures::stamp(const std::filesystem::path& audioPath)
+{
+    std::error_code error;
+    name = audioPath.filename().string();
+    fileSize = uint64_t(std::filesystem::file_size(audioPath, error));
+    fileTime = int64_t(std::filesystem::last_write_time(audioPath, error).time_since_epoch().count());
+}
+
+bool TrackFeatures::isFrom(const std::filesystem::path& audioPath) const
+{
+    TrackFeatures current;
+    current.stamp(audioPath);
+    return name == current.name && fileSize == current.fileSize && fileTime == current.fileTime;
+}
+
+TrackFeatures FeatureStore::compute(AudioSource& source, const OfflineAnalyser& analyser, const std::string& name)
+{
+    const OfflineAnalysisConfig& config = analyser.getConfig();
+
+    TrackFeatures ret;
+    ret.name = name;
+    ret.sampleRate = source.getSampleRate();
+    ret.hop = config.stft.hop;
+    ret.windowSize = config.stft.windowSize;
+
+    if (source.getLength() >= uint64_t(ret.windowSize))
+    {
+        const size_t frames = size_t((source.getLength() - ret.windowSize) / ret.hop + 1);
+        ret.energies.reserve(frames);
+        ret.bandEnergies.reserve(frames);
+    }
+
+    FeatureKernelConfig kernelConfig;
+    kernelConfig.bins = config.stft.windowSize / 2;
+    kernelConfig.bands = config.detector.bands;
+    FeatureKernel kernel(kernelConfig);
+    SpectrumFeatures features;
+
+    Stft stft(config.stft);
+    analyser.forEachFrame(source, stft, 0, [&](const SpectrumFrame& frame) {
+        kernel.process(frame, features);
+        ret.energies.push_back(features.energy);
+        ret.bandEnergies.push_back(features.bandEnergy);
+        return true;
+    });
+
+    return ret;
+}
+
+bool FeatureStore::save(const std::filesystem::path& path, const OfflineAnalysisConfig& config) const
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+    {
+        std::cout << "ERROR::FEATURE_STORE::CANNOT_WRITE " << path << "\n";
+        return false;
+    }
+
+    const std::vector<float> settings = settingsOf(config);
+
+    file.write(MAGIC, sizeof(MAGIC));
+    writeValue(file, uint32_t(settings.size()));
+    file.write(reinterpret_cast<const char*>(settings.data()), std::streamsize(sizeof(float) * settings.size()));
+    writeValue(file, uint32_t(tracks.size()));
+
+    for (const TrackFeatures& track : tracks)
+    {
+        writeValue(file, uint32_t(track.name.size()));
+        file.write(track.name.data(), std::streamsize(track.name.size()));
+        writeValue(file, uint64_t(track.fileSize));
+        writeValue(file, int64_t(track.fileTime));
+        writeValue(file, int32_t(track.sampleRate));
+        writeValue(file, int32_t(track.hop));
+        writeValue(file, int32_t(track.windowSize));
+        writeValue(file, uint64_t(track.frames()));
+        file.write(reinterpret_cast<const char*>(track.energies.data()), std::streamsize(sizeof(float) * track.frames()));
+        file.write(reinterpret_cast<const char*>(track.bandEnergies.data()), std::streamsize(sizeof(float) * track.frames()));
+    }
+
+    return bool(file);
+}
+
+bool FeatureStore::load(const std::filesystem::path& path, const OfflineAnalysisConfig& config)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+
+    // Counts in the file are checked against what is left of it, a damaged file must not turn into a huge allocation
+    file.seekg(0, std::ios::end);
+    const uint64_t fileSize = uint64_t(file.tellg());
+    file.seekg(0, std::ios::beg);
+    const auto remaining = [&]() { return fileSize - uint64_t(file.tellg()); };
+
+    char magic[sizeof(MAGIC)];
+    uint32_t settingsCount = 0;
+    if (!file.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), MAGIC) || !readValue(file, settingsCount) || settingsCount > 1024)
+    {
+        std::cout << "ERROR::FEATURE_STORE::BAD_FILE " << path << "\n";
+        return false;
+    }
+
+    std::vector<float> settings(settingsCount);
+    file.read(reinterpret_cast<char*>(settings.data()), std::streamsize(sizeof(float) * settings.size()));
+    if (settings != settingsOf(config))
+    {
+        std::cout << "ERROR::FEATURE_STORE::SETTINGS_MISMATCH " << path << "\n";
+        return false;
+    }
+
+    uint32_t count = 0;
+    if (!readValue(file, count))
+    {
+        std::cout << "ERROR::FEATURE_STORE::TRUNCATED " << path << "\n";
+        return false;
+    }
+    if (uint64_t(count) * TRACK_HEADER_BYTES > remaining())
+    {
+        std::cout << "ERROR::FEATURE_STORE::BAD_FILE " << path << "\n";
+        return false;
+    }
+
+    std::vector<TrackFeatures> loaded(count);
+    for (TrackFeatures& track : loaded)
+    {
+        uint32_t nameLength = 0;
+        int32_t sampleRate = 0;
+        int32_t hop = 0;
+        int32_t windowSize = 0;
+        uint64_t frames = 0;
+
+        if (!readValue(file, nameLength))
+        {
+            break;
+        }
+        if (nameLength > MAX_NAME_LENGTH || nameLength > remaining())
+        {
+            std::cout << "ERROR::FEATURE_STORE::BAD_FILE " << path << "\n";
+            return false;
+        }
+        track.name.resize(nameLength);
+        file.read(track.name.data(), nameLength);
+
+        if (!readValue(file, track.fileSize) || !readValue(file, track.fileTime) || !readValue(file, sampleRate) || !readValue(file, hop) || !readValue(file, windowSize) || !readValue(file, frames))
+        {
+            break;
+        }
+
+        if (frames > remaining() / (2 * sizeof(float)))
+        {
+            std::cout << "ERROR::FEATURE_STORE::BAD_FILE " << path << "\n";
+            return false;
+        }
+
+        track.sampleRate = sampleRate;
+        track.hop = hop;
+        track.windowSize = windowSize;
+        track.energies.resize(size_t(frames));
+        track.bandEnergies.resize(size_t(frames));
+        file.read(reinterpret_cast<char*>(track.energies.data()), std::streamsize(sizeof(float) * frames));
+        file.read(reinterpret_cast<char*>(track.bandEnergies.data()), std::streamsize(sizeof(float) * frames));
+    }
+
+    if (!file)
+    {
+        std::cout << "ERROR::FEATURE_STORE::TRUNCATED " << path << "\n";
+        return false;
+    }
+
+    tracks = std::move(loaded);
+    return true;
+}
@@ -0,0 +1,159 @@
+#include "FileAudioSource.h"
+
+#include "fmod_errors.h"
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+FMOD::System* FileAudioSource::createDecodingSystem()
+{
+    FMOD::System* system = nullptr;
+    FMOD_RESULT result = FMOD::System_Create(&system);
+    if (result == FMOD_OK)
+    {
+        system->setOutput(FMOD_OUTPUTTYPE_NOSOUND_NRT);
+        result = system->init(1, FMOD_INIT_NORMAL, nullptr);
+    }
+    if (result != FMOD_OK)
+    {
+        std::cout << "ERROR::FILE_AUDIO_SOURCE::SYSTEM_FAILED " << FMOD_ErrorString(result) << "\n";
+        if (system)
+        {
+            system->release();
+        }
+        return nullptr;
+    }
+
+    return system;
+}
+
+FileAudioSource::FileAudioSource(FMOD::System* system, const std::string& path)
+{
+    FMOD_RESULT result = system->createSound(path.c_str(), FMOD_OPENONLY | FMOD_ACCURATETIME, nullptr, &sound);
+    if (result != FMOD_OK)
+    {
+        std::cout << "ERROR::FILE_AUDIO_SOURCE::OPEN_FAILED " << path << " " << FMOD_ErrorString(result) << "\n";
+        sound = nullptr;
+        return;
+    }
+
+    int bits = 0;
+    sound->getFormat(nullptr, &format, &channels, &bits);
+
+    switch (format)
+    {
+        case FMOD_SOUND_FORMAT_PCM8:
+            bytesPerSample = 1;
+            break;
+        case FMOD_SOUND_FORMAT_PCM16:
+            bytesPerSample = 2;
+            break;
+        case FMOD_SOUND_FORMAT_PCM24:
+            bytesPerSample = 3;
+            break;
+        case FMOD_SOUND_FORMAT_PCM32:
+        case FMOD_SOUND_FORMAT_PCMFLOAT:
+            bytesPerSample = 4;
+            break;
+        default:
+            std::cout << "ERROR::FILE_AUDIO_SOURCE::UNSUPPORTED_FORMAT " << path << "\n";
+            sound->release();
+            sound = nullptr;
+            return;
+    }
+
+    float frequency = 0.0f;
+    sound->getDefaults(&frequency, nullptr);
+    sampleRate = int(frequency);
+
+    unsigned int pcmLength = 0;
+    sound->getLength(&pcmLength, FMOD_TIMEUNIT_PCM);
+    length = pcmLength;
+}
+
+FileAudioSource::~FileAudioSource()
+{
+    if (sound)
+    {
+        sound->release();
+    }
+}
+
+bool FileAudioSource::seek(const uint64_t frame)
+{
+    if (sound == nullptr)
+    {
+        return false;
+    }
+
+    const FMOD_RESULT result = sound->seekData((unsigned int)frame);
+    if (result != FMOD_OK)
+    {
+        std::cout << "ERROR::FILE_AUDIO_SOURCE::SEEK_FAILED " << FMOD_ErrorString(result) << "\n";
+        return false;
+    }
+    return true;
+}
+
+int FileAudioSource::read(float* interleaved, const int frames)
+{
+    if (sound == nullptr || frames <= 0)
+    {
+        return 0;
+    }
+
+    const size_t frameBytes = size_t(channels) * size_t(bytesPerSample);
+    raw.resize(size_t(frames) * frameBytes);
+
+    unsigned int bytesRead = 0;
+    const FMOD_RESULT result = sound->readData(raw.data(), (unsigned int)raw.size(), &bytesRead);
+    if (result != FMOD_OK && result != FMOD_ERR_FILE_EOF)
+    {
+        std::cout << "ERROR::FILE_AUDIO_SOURCE::READ_FAILED " << FMOD_ErrorString(result) << "\n";
+        return 0;
+    }
+
+    const int framesRead = int(bytesRead / frameBytes);
+    const int samples = framesRead * channels;
+    const unsigned char* in = raw.data();
+
+    switch (format)
+    {
+        case FMOD_SOUND_FORMAT_PCM8:
+            for (int i = 0; i < samples; ++i)
+            {
+                interleaved[i] = int8_t(in[i]) / 128.0f;
+            }
+            break;
+        case FMOD_SOUND_FORMAT_PCM16:
+            for (int i = 0; i < samples; ++i)
+            {
+                int16_t value;
+                std::memcpy(&value, in + 2 * size_t(i), sizeof(value));
+                interleaved[i] = value / 32768.0f;
+            }
+            break;
+        case FMOD_SOUND_FORMAT_PCM24:
+            for (int i = 0; i < samples; ++i)
+            {
+                const unsigned char* sample = in + 3 * size_t(i);
+                const int32_t value = int32_t(uint32_t(sample[0]) << 8 | uint32_t(sample[1]) << 16 | uint32_t(sample[2]) << 24) >> 8;
+                interleaved[i] = value / 8388608.0f;
+            }
+            break;
+        case FMOD_SOUND_FORMAT_PCM32:
+            for (int i = 0; i < samples; ++i)
+            {
+                int32_t value;
+                std::memcpy(&value, in + 4 * size_t(i), sizeof(value));
+                interleaved[i] = float(value / 2147483648.0);
+            }
+            break;
+        default:
+            std::memcpy(interleaved, in, sizeof(float) * size_t(samples));
+            break;
+    }
+
+    return framesRead;
+}
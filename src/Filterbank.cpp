@@ -0,0 +1,200 @@
+#include "Filterbank.h"
+
+#include "FastMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+float toScale(const FilterbankScale scale, const float frequency)
+{
+    switch (scale)
+    {
+        case FilterbankScale::Mel:
+            return 2595.0f * std::log10(1.0f + frequency / 700.0f);
+        case FilterbankScale::Bark:
+            return 26.81f * frequency / (1960.0f + frequency) - 0.53f;  // Traunmueller
+        default:
+            return std::log2(frequency);
+    }
+}
+
+float fromScale(const FilterbankScale scale, const float value)
+{
+    switch (scale)
+    {
+        case FilterbankScale::Mel:
+            return 700.0f * (std::pow(10.0f, value / 2595.0f) - 1.0f);
+        case FilterbankScale::Bark:
+            return 1960.0f * (value + 0.53f) / (26.28f - value);
+        default:
+            return std::exp2(value);
+    }
+}
+}  // namespace
+
+Filterbank::Filterbank(const FilterbankConfig& configArg)
+    : config(configArg)
+{
+    rowStart.reserve(config.buckets + 1);
+    rowFirstBin.reserve(config.buckets);
+    rowStart.push_back(0);
+
+    const float nyquist = config.sampleRate / 2;
+
+    switch (config.scale)
+    {
+        case FilterbankScale::Linear:
+        {
+            const int bucketsize = (config.bins / config.buckets) + 1;  // round up
+
+            std::vector<int> bucketOfBin(config.bins);
+            for (int i = 0; i < config.bins; ++i)
+            {
+                bucketOfBin[i] = i / bucketsize;
+            }
+            buildRectangular(bucketOfBin);
+            centres = bucketCentreFrequencies(config.buckets, config.bins, false);
+            break;
+        }
+        case FilterbankScale::Log:
+        {
+            // Same assignment as fillCountsLog, worked out once instead of searched for every bin of every hop
+            const std::vector<float> limits = logBucketLimits(config.buckets);
+
+            std::vector<int> bucketOfBin(config.bins, -1);
+            for (int i = 0; i < config.bins; ++i)
+            {
+                const float currentFreq = nyquist * (float(i) / config.bins);
+                if (currentFreq > limits.back())
+                {
+                    bucketOfBin[i] = config.buckets - 1;
+                    continue;
+                }
+
+                for (int j = 0; j < config.buckets - 1; ++j)
+                {
+                    if (currentFreq < limits[j + 1])
+                    {
+                        bucketOfBin[i] = j;
+                        break;
+                    }
+                }
+            }
+            buildRectangular(bucketOfBin);
+            centres = bucketCentreFrequencies(config.buckets, config.bins, true);
+            break;
+        }
+        default:
+            buildTriangular();
+            break;
+    }
+}
+
+void Filterbank::buildRectangular(const std::vector<int>& bucketOfBin)
+{
+    // bucketOfBin never decreases, so every bucket gets one run of bins
+    int bin = 0;
+    for (int bucket = 0; bucket < config.buckets; ++bucket)
+    {
+        while (bin < config.bins && bucketOfBin[bin] >= 0 && bucketOfBin[bin] < bucket)
+        {
+            ++bin;
+        }
+        while (bin < config.bins && bucketOfBin[bin] < 0)
+        {
+            ++bin;
+        }
+
+        const int first = bin;
+        while (bin < config.bins && bucketOfBin[bin] == bucket)
+        {
+            ++bin;
+        }
+
+        addRow(first, std::vector<float>(size_t(bin - first), 1.0f));
+    }
+}
+
+void Filterbank::buildTriangular()
+{
+    const float nyquist = config.sampleRate / 2;
+    const float binWidth = nyquist / config.bins;
+
+    const float low = toScale(config.scale, std::max(config.minFrequency, binWidth));
+    const float high = toScale(config.scale, std::min(config.maxFrequency, nyquist));
+
+    // Filter i rises from edge i to its centre at edge i + 1 and falls back to zero at edge i + 2
+    std::vector<float> edges(size_t(config.buckets) + 2);
+    for (size_t i = 0; i < edges.size(); ++i)
+    {
+        edges[i] = fromScale(config.scale, low + (high - low) * float(i) / float(config.buckets + 1));
+    }
+
+    std::vector<float> row;
+    for (int bucket = 0; bucket < config.buckets; ++bucket)
+    {
+        const float left = edges[bucket];
+        const float centre = edges[bucket + 1];
+        const float right = edges[bucket + 2];
+
+        const int first = std::max(int(std::ceil(left / binWidth)), 0);
+        const int last = std::min(int(std::floor(right / binWidth)), config.bins - 1);
+
+        row.clear();
+        for (int i = first; i <= last; ++i)
+        {
+            const float frequency = i * binWidth;
+            const float weight = frequency <= centre ? (frequency - left) / (centre - left) : (right - frequency) / (right - centre);
+            row.push_back(std::max(weight, 0.0f));
+        }
+
+        // Low filters can be narrower than a bin, they take the nearest bin instead of staying silent
+        if (row.empty() || *std::max_element(row.begin(), row.end()) <= 0.0f)
+        {
+            addRow(std::min(int(std::lround(centre / binWidth)), config.bins - 1), { 1.0f });
+        }
+        else
+        {
+            addRow(first, row);
+        }
+
+        centres.push_back(centre);
+    }
+}
+
+void Filterbank::addRow(const int firstBin, const std::vector<float>& rowWeights)
+{
+    rowFirstBin.push_back(firstBin);
+    weights.insert(weights.end(), rowWeights.begin(), rowWeights.end());
+    rowStart.push_back(int(weights.size()));
+}
+
+void Filterbank::apply(std::vector<float>& counts, const SpectrumFrame& frame, const int channel) const
+{
+    if (frame.bins() != config.bins)
+    {
+        return;
+    }
+
+    if (counts.size() < size_t(config.buckets))
+    {
+        std::cout << "ERROR::FILTERBANK::NOT_ENOUGH_BUCKETS\n";
+        return;
+    }
+
+    const int firstChannel = channel == ALL_CHANNELS ? 0 : channel;
+    const int lastChannel = channel == ALL_CHANNELS ? frame.numChannels : channel + 1;
+
+    for (int c = firstChannel; c < lastChannel; ++c)
+    {
+        const float* spectrum = frame.channel(c);
+        for (int bucket = 0; bucket < config.buckets; ++bucket)
+        {
+            const int start = rowStart[bucket];
+            counts[bucket] += dotProduct(weights.data() + start, spectrum + rowFirstBin[bucket], rowStart[bucket + 1] - start);
+        }
+    }
+}
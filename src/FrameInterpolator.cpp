@@ -0,0 +1,41 @@
+#include "FrameInterpolator.h"
+
+#include <algorithm>
+
+FrameInterpolator::FrameInterpolator(const int sizeArg)
+    : size(sizeArg)
+{
+    frames[0].resize(size);
+    frames[1].resize(size);
+}
+
+void FrameInterpolator::push(const std::chrono::steady_clock::time_point time, const std::vector<float>& values)
+{
+    std::swap(frames[0], frames[1]);
+    times[0] = times[1];
+
+    std::copy(values.begin(), values.begin() + std::min(int(values.size()), size), frames[1].begin());
+    times[1] = time;
+
+    count = std::min(count + 1, 2);
+}
+
+void FrameInterpolator::sample(const std::chrono::steady_clock::time_point displayTime, std::vector<float>& out) const
+{
+    out.resize(size);
+
+    if (count < 2 || times[1] <= times[0])
+    {
+        std::copy(frames[1].begin(), frames[1].end(), out.begin());
+        return;
+    }
+
+    const std::chrono::duration<float> interval = times[1] - times[0];
+    const std::chrono::duration<float> sinceNewest = displayTime - times[1];
+    const float alpha = std::clamp(sinceNewest / interval, 0.0f, 1.0f);
+
+    for (int i = 0; i < size; ++i)
+    {
+        out[i] = frames[0][i] + (frames[1][i] - frames[0][i]) * alpha;
+    }
+}
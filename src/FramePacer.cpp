@@ -0,0 +1,77 @@
+#include "FramePacer.h"
+
+#include <GLFW/glfw3.h>
+
+#include <thread>
+
+namespace
+{
+// OS sleeps are only this precise, the rest of the wait is spent yielding
+constexpr std::chrono::milliseconds SLEEP_SLACK{ 2 };
+}  // namespace
+
+FramePacer::FramePacer(const float targetFps, const VsyncMode vsyncArg)
+    : period(
+          targetFps > 0.0f ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / targetFps))
+                           : std::chrono::steady_clock::duration::zero())
+    , vsync(vsyncArg)
+{
+}
+
+void FramePacer::apply() const
+{
+    switch (vsync)
+    {
+        case VsyncMode::Off:
+            glfwSwapInterval(0);
+            break;
+        case VsyncMode::On:
+            glfwSwapInterval(1);
+            break;
+        case VsyncMode::Adaptive:
+            if (glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+            {
+                glfwSwapInterval(-1);
+            }
+            else
+            {
+                glfwSwapInterval(1);
+            }
+            break;
+    }
+}
+
+std::chrono::steady_clock::time_point FramePacer::waitForNextFrame()
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (period == std::chrono::steady_clock::duration::zero())
+    {
+        return now;
+    }
+
+    // More than a whole frame behind, don't try to catch up with a burst of frames
+    if (now > nextFrame + period)
+    {
+        nextFrame = now;
+    }
+
+    if (pumpEvents)
+    {
+        for (auto current = now; nextFrame - current > SLEEP_SLACK; current = std::chrono::steady_clock::now())
+        {
+            glfwWaitEventsTimeout(std::chrono::duration<double>(nextFrame - SLEEP_SLACK - current).count());
+        }
+    }
+    else if (nextFrame - now > SLEEP_SLACK)
+    {
+        std::this_thread::sleep_until(nextFrame - SLEEP_SLACK);
+    }
+    while (std::chrono::steady_clock::now() < nextFrame)
+    {
+        std::this_thread::yield();
+    }
+
+    const auto ret = nextFrame;
+    nextFrame += period;
+    return ret;
+}
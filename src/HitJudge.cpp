@@ -0,0 +1,63 @@
+#include "HitJudge.h"
+
+#include <cmath>
+#include <cstdlib>
+
+HitJudge::HitJudge(const int sampleRate, const float windowSeconds)
+    : window(uint64_t(std::lround(sampleRate * windowSeconds)))
+{
+}
+
+void HitJudge::addBeat(const BeatEvent& beat)
+{
+    beats.push_back(beat.samplePosition);
+}
+
+void HitJudge::addPress(const uint64_t samplePosition)
+{
+    presses.push_back(samplePosition);
+}
+
+void HitJudge::judge(const uint64_t analysedPosition, std::vector<JudgedPress>& out)
+{
+    while (!presses.empty() && presses.front() + window <= analysedPosition)
+    {
+        const uint64_t press = presses.front();
+        presses.pop_front();
+
+        // Beats too old for this press are too old for every later one as well
+        while (!beats.empty() && beats.front() + window < press)
+        {
+            beats.pop_front();
+        }
+
+        JudgedPress judged;
+        judged.samplePosition = press;
+
+        // The closest unclaimed beat inside the window, the deque is sorted so the search can stop early
+        auto best = beats.end();
+        for (auto it = beats.begin(); it != beats.end() && *it <= press + window; ++it)
+        {
+            if (best == beats.end() || std::llabs(int64_t(press) - int64_t(*it)) < std::llabs(int64_t(press) - int64_t(*best)))
+            {
+                best = it;
+            }
+        }
+
+        if (best != beats.end())
+        {
+            judged.hit = true;
+            judged.offset = int64_t(press) - int64_t(*best);
+            beats.erase(best);
+        }
+
+        out.push_back(judged);
+    }
+
+    // Only pending presses can still claim a beat, without any the deque would keep every beat of the run
+    const uint64_t earliest = presses.empty() ? analysedPosition : presses.front();
+    while (!beats.empty() && beats.front() + window < earliest)
+    {
+        beats.pop_front();
+    }
+}
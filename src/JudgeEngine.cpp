@@ -0,0 +1,84 @@
+#include "JudgeEngine.h"
+
+#include <algorithm>
+#include <cmath>
+
+JudgeEngine::JudgeEngine(const Chart& chart, const JudgeConfig& configArg)
+    : config(configArg)
+    , perfectWindow(uint64_t(std::lround(chart.sampleRate * configArg.perfectWindow)))
+    , goodWindow(uint64_t(std::lround(chart.sampleRate * configArg.goodWindow)))
+    , judged(chart.beats.size(), false)
+{
+    positions.reserve(chart.beats.size());
+    for (const BeatEvent& beat : chart.beats)
+    {
+        positions.push_back(beat.samplePosition);
+    }
+}
+
+JudgeResult JudgeEngine::press(const uint64_t samplePosition)
+{
+    JudgeResult ret;
+
+    // Candidates are the beats inside the good window, only a handful at most
+    const uint64_t earliest = samplePosition > goodWindow ? samplePosition - goodWindow : 0;
+    auto it = std::lower_bound(positions.begin() + firstOpen, positions.end(), earliest);
+
+    uint64_t bestDistance = goodWindow + 1;
+    for (; it != positions.end() && *it <= samplePosition + goodWindow; ++it)
+    {
+        const size_t index = size_t(it - positions.begin());
+        const uint64_t distance = *it > samplePosition ? *it - samplePosition : samplePosition - *it;
+        if (!judged[index] && distance < bestDistance)
+        {
+            bestDistance = distance;
+            ret.beat = int(index);
+        }
+    }
+
+    if (ret.beat >= 0)
+    {
+        judged[ret.beat] = true;
+        ret.offset = int64_t(samplePosition) - int64_t(positions[ret.beat]);
+        ret.judgement = bestDistance <= perfectWindow ? Judgement::Perfect : Judgement::Good;
+    }
+
+    record(ret.judgement);
+    return ret;
+}
+
+int JudgeEngine::advance(const uint64_t samplePosition)
+{
+    int missed = 0;
+    while (firstOpen < positions.size() && positions[firstOpen] + goodWindow < samplePosition)
+    {
+        if (!judged[firstOpen])
+        {
+            judged[firstOpen] = true;
+            record(Judgement::Miss);
+            ++missed;
+        }
+        ++firstOpen;
+    }
+    return missed;
+}
+
+void JudgeEngine::record(const Judgement judgement)
+{
+    ++counts[int(judgement)];
+
+    switch (judgement)
+    {
+        case Judgement::Perfect:
+            score += config.perfectScore;
+            break;
+        case Judgement::Good:
+            score += config.goodScore;
+            break;
+        case Judgement::Miss:
+            combo = 0;
+            return;
+    }
+
+    maxCombo = std::max(maxCombo, ++combo);
+}
@@ -9,44 +9,46 @@ KeyPressWatcher::KeyPressWatcher(const int keyToWatch)
 {
 }
 
-void KeyPressWatcher::update(GLFWwindow* window)
+void KeyPressWatcher::install(GLFWwindow* window)
 {
-    const auto currentTime = std::chrono::steady_clock::now();
-    const auto msecsSinceLastUpdate = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - lastUpdateTime).count();
+    glfwSetWindowUserPointer(window, this);
+    previousCallback = glfwSetKeyCallback(window, keyCallback);
+}
 
-    msecGrace -= msecsSinceLastUpdate;
-    msecPenalty -= msecsSinceLastUpdate;
+void KeyPressWatcher::keyCallback(GLFWwindow* window, const int key, const int scancode, const int action, const int mods)
+{
+    const auto now = std::chrono::steady_clock::now();
 
-    if (msecGrace < 0)
+    KeyPressWatcher* watcher = static_cast<KeyPressWatcher*>(glfwGetWindowUserPointer(window));
+    if (watcher == nullptr)
     {
-        msecGrace = 0;
+        return;
     }
-    if (msecPenalty < 0)
+
+    if (watcher->previousCallback)
     {
-        msecPenalty = 0;
+        watcher->previousCallback(window, key, scancode, action, mods);
     }
 
-    if (glfwGetKey(window, watchedKey) == GLFW_PRESS)
+    // Key repeat is not a new press
+    if (key != watcher->watchedKey || action == GLFW_REPEAT)
     {
-        pressed = true;
+        return;
     }
-    else if (glfwGetKey(window, watchedKey) == GLFW_RELEASE)
+
+    if (!watcher->events.tryPush(KeyPress{ now, action == GLFW_PRESS }))
     {
-        pressed = false;
+        std::cout << "ERROR::KEY_PRESS_WATCHER::QUEUE_FULL\n";
     }
-
-    lastUpdateTime = currentTime;
 }
 
-bool KeyPressWatcher::isOK() const
+bool KeyPressWatcher::poll(KeyPress& event)
 {
-    std::cout << "penalty: " << msecPenalty << "\n";
-    std::cout << "grace: " << msecGrace << "\n";
-
-    if (pressed && (msecPenalty < 1 || msecGrace > 0))
+    if (!events.tryPop(event))
     {
-        return true;
+        return false;
     }
 
-    return false;
-}
\ No newline at end of file
+    pressed = event.pressed;
+    return true;
+}
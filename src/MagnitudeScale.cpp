@@ -0,0 +1,45 @@
+#include "MagnitudeScale.h"
+
+#include "FastMath.h"
+
+#include <algorithm>
+#include <cmath>
+
+MagnitudeScale::MagnitudeScale(const std::vector<float>& frequencies, const MagnitudeScaleConfig& configArg)
+    : config(configArg)
+    , floorMagnitude(std::pow(10.0f, configArg.floorDb / 20.0f))
+{
+    offsets.reserve(frequencies.size());
+    for (const float frequency : frequencies)
+    {
+        const float weighting = config.weighting == MagnitudeWeighting::A ? aWeightingDb(frequency) : 0.0f;
+        offsets.push_back(weighting - config.floorDb);
+    }
+}
+
+float MagnitudeScale::aWeightingDb(const float frequency)
+{
+    // Anything below 1 Hz is treated as 1 Hz, the curve goes to minus infinity at DC
+    const double f2 = std::max(double(frequency), 1.0) * std::max(double(frequency), 1.0);
+    const double num = 12194.0 * 12194.0 * f2 * f2;
+    const double den = (f2 + 20.6 * 20.6) * std::sqrt((f2 + 107.7 * 107.7) * (f2 + 737.9 * 737.9)) * (f2 + 12194.0 * 12194.0);
+    return float(20.0 * std::log10(num / den) + 2.0);
+}
+
+void MagnitudeScale::apply(float* values, const int count) const
+{
+    const int n = std::min(count, int(offsets.size()));
+
+    fastDecibels(values, n, floorMagnitude);
+
+    for (int i = 0; i < n; ++i)
+    {
+        const float level = values[i] + offsets[i];
+        values[i] = level > 0.0f ? level : 0.0f;
+    }
+}
+
+void MagnitudeScale::apply(std::vector<float>& values) const
+{
+    apply(values.data(), int(values.size()));
+}
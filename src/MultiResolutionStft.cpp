@@ -0,0 +1,56 @@
+#include "MultiResolutionStft.h"
+
+#include <algorithm>
+
+namespace
+{
+int longestWindow(const std::vector<StftConfig>& configs)
+{
+    int ret = 0;
+    for (const StftConfig& config : configs)
+    {
+        ret = std::max(ret, config.windowSize);
+    }
+    return ret;
+}
+}  // namespace
+
+MultiResolutionStft::MultiResolutionStft(const int channels, const std::vector<StftConfig>& configs, const uint64_t startPosition, const int ringCapacity)
+    : ring(channels, std::max(ringCapacity, 2 * longestWindow(configs)), startPosition)
+{
+    const int longest = longestWindow(configs);
+
+    for (const StftConfig& config : configs)
+    {
+        stfts.push_back(std::make_unique<Stft>(config));
+
+        // Shorter windows start later so their first centre matches the longest window's
+        stfts.back()->setPosition(startPosition + uint64_t(longest - config.windowSize) / 2);
+    }
+}
+
+void MultiResolutionStft::write(const float* interleaved, const int frames)
+{
+    ring.write(interleaved, frames);
+}
+
+void MultiResolutionStft::writeSilence(const int frames)
+{
+    ring.writeSilence(frames);
+}
+
+bool MultiResolutionStft::next(const int resolution, SpectrumFrame& frame)
+{
+    return stfts[resolution]->next(ring, frame);
+}
+
+uint64_t MultiResolutionStft::getNextCentre(const int resolution) const
+{
+    const Stft& stft = *stfts[resolution];
+    return stft.getNextStart(ring) + uint64_t(stft.getConfig().windowSize / 2);
+}
+
+bool MultiResolutionStft::isReady(const int resolution) const
+{
+    return stfts[resolution]->isReady(ring);
+}
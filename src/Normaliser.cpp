@@ -0,0 +1,57 @@
+#include "Normaliser.h"
+
+#include "FastMath.h"
+
+#include <algorithm>
+#include <cmath>
+
+Normaliser::Normaliser(const NormaliserConfig& configArg)
+    : config(configArg)
+{
+}
+
+float Normaliser::getReference() const
+{
+    const float level = config.reference == NormalisationReference::Peak ? peak : std::sqrt(meanSquare) * config.rmsHeadroom;
+    return std::max(level, config.minimumReference);
+}
+
+void Normaliser::process(std::vector<float>& values, const float dt)
+{
+    if (values.empty())
+    {
+        return;
+    }
+
+    float frameMax{ 0.0f };
+    float frameSquares{ 0.0f };
+    for (const float value : values)
+    {
+        frameMax = std::max(frameMax, value);
+        frameSquares += value * value;
+    }
+
+    const float step = std::max(dt, 0.0f);
+    peak = std::max(frameMax, peak * std::exp(-step / config.peakReleaseTime));
+    meanSquare += (frameSquares / values.size() - meanSquare) * (1.0f - std::exp(-step / config.rmsTime));
+
+    const float reference = getReference();
+
+    if (config.decibels)
+    {
+        const float range = -config.noiseFloorDb;
+        for (float& value : values)
+        {
+            const float db = fastDecibels(std::max(value / reference, config.minimumReference));
+            value = std::clamp((db - config.noiseFloorDb) / range, 0.0f, 1.0f);
+        }
+    }
+    else
+    {
+        const float scale = 1.0f / reference;
+        for (float& value : values)
+        {
+            value = std::min(value * scale, 1.0f);
+        }
+    }
+}
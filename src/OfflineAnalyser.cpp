@@ -0,0 +1,213 @@
+#include "OfflineAnalyser.h"
+
+#include "AudioSource.h"
+#include "PcmRingBuffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <thread>
+
+namespace
+{
+// Decoders of compressed formats need some audio before the seek target to produce the same samples again
+constexpr uint64_t SEEK_PREROLL = 8192;
+
+// Segments per thread, so a slow segment does not leave the other threads idle at the end
+constexpr int SEGMENTS_PER_THREAD = 4;
+}  // namespace
+
+OfflineAnalyser::OfflineAnalyser(const OfflineAnalysisConfig& configArg)
+    : config(configArg)
+{
+}
+
+Chart OfflineAnalyser::analyse(AudioSource& source) const
+{
+    Chart chart;
+    chart.sampleRate = source.getSampleRate();
+    chart.length = source.getLength();
+
+    Stft stft(config.stft);
+    const uint64_t consumed = analyseFrames(source, stft, 0, std::numeric_limits<uint64_t>::max(), chart.beats);
+
+    if (chart.length == 0)
+    {
+        chart.length = consumed;
+    }
+
+    mergeBeats(chart.beats, chart.sampleRate, config.minBeatInterval);
+
+    return chart;
+}
+
+Chart OfflineAnalyser::analyseParallel(const SourceFactory& openSource, int threads) const
+{
+    if (threads <= 0)
+    {
+        threads = int(std::max(std::thread::hardware_concurrency(), 1u));
+    }
+
+    std::unique_ptr<AudioSource> first = openSource();
+    if (!first)
+    {
+        return Chart{};
+    }
+
+    const uint64_t length = first->getLength();
+    const uint64_t window = uint64_t(config.stft.windowSize);
+    const uint64_t hop = uint64_t(config.stft.hop);
+    const uint64_t frames = length >= window ? (length - window) / hop + 1 : 0;
+
+    // Segment starts are multiples of the detector history, that puts the detector's ring at the same index as in a sequential run.
+    // Otherwise its sums would add up in a different order and could round differently.
+    const uint64_t history = uint64_t(std::max(config.detector.history, 1));
+    const uint64_t segmentFrames = std::max<uint64_t>(((frames / (uint64_t(threads) * SEGMENTS_PER_THREAD)) / history + 1) * history, 4 * history);
+    const uint64_t segments = (frames + segmentFrames - 1) / segmentFrames;
+
+    if (threads == 1 || segments < 2 || !first->seek(0))
+    {
+        return analyse(*first);
+    }
+
+    threads = int(std::min<uint64_t>(uint64_t(threads), segments));
+
+    // Sources are opened on this thread, the factory does not have to be thread safe
+    std::vector<std::unique_ptr<AudioSource>> sources;
+    std::vector<std::unique_ptr<Stft>> stfts;
+    sources.push_back(std::move(first));
+    for (int i = 0; i < threads; ++i)
+    {
+        if (i > 0)
+        {
+            sources.push_back(openSource());
+            if (!sources.back())
+            {
+                std::cout << "ERROR::OFFLINE_ANALYSER::SOURCE_FAILED\n";
+                return analyse(*sources.front());
+            }
+        }
+        stfts.push_back(std::make_unique<Stft>(config.stft));
+    }
+
+    std::vector<std::vector<BeatEvent>> results(segments);
+    std::atomic<uint64_t> nextSegment{ 0 };
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i)
+    {
+        workers.emplace_back([&, i]() {
+            for (uint64_t segment = nextSegment++; segment < segments; segment = nextSegment++)
+            {
+                const uint64_t begin = segment * segmentFrames;
+                analyseFrames(*sources[i], *stfts[i], begin, std::min(begin + segmentFrames, frames), results[segment]);
+            }
+        });
+    }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    Chart chart;
+    chart.sampleRate = sources.front()->getSampleRate();
+    chart.length = length;
+    for (const std::vector<BeatEvent>& result : results)
+    {
+        chart.beats.insert(chart.beats.end(), result.begin(), result.end());
+    }
+
+    // Merged after the segments are joined, so a run of detections across a segment border is merged like in a sequential run
+    mergeBeats(chart.beats, chart.sampleRate, config.minBeatInterval);
+
+    return chart;
+}
+
+void OfflineAnalyser::mergeBeats(std::vector<BeatEvent>& beats, const int sampleRate, const float minInterval)
+{
+    const uint64_t minimum = uint64_t(std::max(std::llround(double(minInterval) * sampleRate), 0ll));
+    if (minimum == 0 || beats.empty())
+    {
+        return;
+    }
+
+    size_t kept = 0;
+    for (size_t i = 1; i < beats.size(); ++i)
+    {
+        if (beats[i].samplePosition - beats[kept].samplePosition >= minimum)
+        {
+            beats[++kept] = beats[i];
+        }
+    }
+    beats.resize(kept + 1);
+}
+
+uint64_t OfflineAnalyser::analyseFrames(AudioSource& source, Stft& stft, const uint64_t firstFrame, const uint64_t endFrame, std::vector<BeatEvent>& beats) const
+{
+    const uint64_t history = uint64_t(std::max(config.detector.history, 1));
+    const uint64_t warmupFrame = firstFrame > history ? firstFrame - history : 0;
+
+    BeatDetector detector(config.detector);
+    uint64_t frameIndex = warmupFrame;
+
+    return forEachFrame(source, stft, warmupFrame * uint64_t(config.stft.hop), [&](const SpectrumFrame& frame) {
+        if (frameIndex >= endFrame)
+        {
+            return false;
+        }
+
+        const std::optional<BeatEvent> beat = detector.process(frame);
+        if (beat && frameIndex >= firstFrame)
+        {
+            beats.push_back(*beat);
+        }
+        ++frameIndex;
+        return true;
+    });
+}
+
+uint64_t OfflineAnalyser::forEachFrame(AudioSource& source, Stft& stft, const uint64_t startSample, const std::function<bool(const SpectrumFrame&)>& visit) const
+{
+    const ChannelMixer mixer(config.layout);
+    const int channels = ChannelMixer::outputChannels(config.layout, source.getChannels());
+    if (channels == 0)
+    {
+        return 0;
+    }
+
+    // A source that can not seek is fine as long as it is read from the start
+    const uint64_t readPosition = startSample > SEEK_PREROLL ? startSample - SEEK_PREROLL : 0;
+    if (!source.seek(readPosition) && readPosition > 0)
+    {
+        return 0;
+    }
+
+    PcmRingBuffer ring(channels, std::max(2 * config.stft.windowSize, config.blockFrames + config.stft.windowSize), readPosition);
+    stft.setPosition(startSample);
+
+    std::vector<float> block(size_t(config.blockFrames) * size_t(source.getChannels()));
+    std::vector<float> mixed;
+    SpectrumFrame frame;
+
+    for (;;)
+    {
+        const int read = source.read(block.data(), config.blockFrames);
+        if (read == 0)
+        {
+            return ring.getWritePosition();
+        }
+
+        mixer.process(block.data(), source.getChannels(), read, mixed);
+        ring.write(mixed.data(), read);
+
+        while (stft.next(ring, frame))
+        {
+            if (!visit(frame))
+            {
+                return ring.getWritePosition();
+            }
+        }
+    }
+}
@@ -0,0 +1,126 @@
+#include "OffscreenTarget.h"
+
+#include <algorithm>
+#include <iostream>
+
+OffscreenTarget::OffscreenTarget(const int widthArg, const int heightArg)
+    : width(widthArg)
+    , height(heightArg)
+{
+    glGenFramebuffers(1, &FBO);
+    glGenRenderbuffers(1, &colorRBO);
+    glGenRenderbuffers(1, &depthRBO);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, colorRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRBO);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cout << "ERROR::OFFSCREEN_TARGET::FRAMEBUFFER_INCOMPLETE" << std::endl;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    glGenBuffers(PBOS, PBO.data());
+    for (const GLuint buffer : PBO)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, GLsizeiptr(width) * height * 4, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+OffscreenTarget::~OffscreenTarget()
+{
+    for (GLsync& sync : fences)
+    {
+        if (sync)
+        {
+            glDeleteSync(sync);
+            sync = nullptr;
+        }
+    }
+
+    glDeleteBuffers(PBOS, PBO.data());
+    glDeleteFramebuffers(1, &FBO);
+    glDeleteRenderbuffers(1, &colorRBO);
+    glDeleteRenderbuffers(1, &depthRBO);
+}
+
+void OffscreenTarget::bind() const
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glViewport(0, 0, width, height);
+}
+
+void OffscreenTarget::unbind() const
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void OffscreenTarget::readback()
+{
+    if (pending == PBOS)
+    {
+        std::cout << "ERROR::OFFSCREEN_TARGET::NO_FREE_PBO" << std::endl;
+        return;
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, PBO[writeIndex]);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    fences[writeIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    writeIndex = (writeIndex + 1) % PBOS;
+    ++pending;
+}
+
+bool OffscreenTarget::collect(std::vector<unsigned char>& pixels, const bool wait)
+{
+    if (pending == 0)
+    {
+        return false;
+    }
+
+    const int readIndex = (writeIndex - pending + PBOS) % PBOS;
+    GLsync& sync = fences[readIndex];
+
+    GLenum waitResult = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (waitResult == GL_TIMEOUT_EXPIRED && !wait)
+    {
+        return false;
+    }
+    while (waitResult == GL_TIMEOUT_EXPIRED)
+    {
+        waitResult = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);  // 1 ms
+    }
+
+    glDeleteSync(sync);
+    sync = nullptr;
+
+    const size_t size = size_t(width) * height * 4;
+    pixels.resize(size);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, PBO[readIndex]);
+    const auto* mapped = static_cast<const unsigned char*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, GLsizeiptr(size), GL_MAP_READ_BIT));
+    if (mapped)
+    {
+        std::copy(mapped, mapped + size, pixels.begin());
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    --pending;
+    return mapped != nullptr;
+}
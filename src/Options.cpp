@@ -0,0 +1,113 @@
+#include "Options.h"
+
+#include <iostream>
+
+namespace
+{
+void printUsage(const char* executable)
+{
+    std::cout << "Usage: " << executable << " [options]\n"
+              << "  --sound <file>        sound to play from the sounds folder\n"
+              << "  --signal <preset>     play generated audio instead: click, drums, swing, noise or sweep\n"
+              << "  --bpm <bpm>           tempo of the generated audio\n"
+              << "  --length <seconds>    length of the generated audio\n"
+              << "  --chart               analyse the song up front and score presses against its beats\n"
+              << "  --sweep <folder>      tune the beat detector against the annotated sounds of a folder\n"
+              << "  --features <file>     feature cache of the sweep\n"
+              << "  --evaluate <folder>   report beat detection accuracy and speed, on synthetic tracks too\n"
+              << "  --record <file>       record the analysis frames into a file\n"
+              << "  --replay <file>       analyse and render recorded frames instead of playing a sound\n"
+              << "  --offscreen <frames>  render the given number of frames without a visible window\n"
+              << "  --fps <fps>           time step of the offscreen mode\n"
+              << "  --frames-out <file>   write the offscreen frames as raw RGBA into this file\n";
+}
+}  // namespace
+
+std::optional<Options> parseOptions(const int argc, char* argv[])
+{
+    Options ret;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        try
+        {
+            if (arg == "--sound" && hasValue)
+            {
+                ret.sound = argv[++i];
+            }
+            else if (arg == "--signal" && hasValue)
+            {
+                ret.signal = argv[++i];
+            }
+            else if (arg == "--bpm" && hasValue)
+            {
+                ret.signalBpm = std::stod(argv[++i]);
+            }
+            else if (arg == "--length" && hasValue)
+            {
+                ret.signalSeconds = std::stod(argv[++i]);
+            }
+            else if (arg == "--chart")
+            {
+                ret.chart = true;
+            }
+            else if (arg == "--sweep" && hasValue)
+            {
+                ret.sweepFolder = argv[++i];
+            }
+            else if (arg == "--features" && hasValue)
+            {
+                ret.featureCache = argv[++i];
+            }
+            else if (arg == "--evaluate" && hasValue)
+            {
+                ret.evaluationFolder = argv[++i];
+            }
+            else if (arg == "--record" && hasValue)
+            {
+                ret.recordPath = argv[++i];
+            }
+            else if (arg == "--replay" && hasValue)
+            {
+                ret.replayPath = argv[++i];
+            }
+            else if (arg == "--offscreen" && hasValue)
+            {
+                ret.offscreen = true;
+                ret.offscreenFrames = std::stoi(argv[++i]);
+            }
+            else if (arg == "--fps" && hasValue)
+            {
+                ret.offscreenFps = std::stof(argv[++i]);
+            }
+            else if (arg == "--frames-out" && hasValue)
+            {
+                ret.framesOutput = argv[++i];
+            }
+            else
+            {
+                printUsage(argv[0]);
+                return std::nullopt;
+            }
+        } catch (const std::exception&)
+        {
+            std::cout << "Invalid value for " << arg << "\n";
+            printUsage(argv[0]);
+            return std::nullopt;
+        }
+    }
+
+    // A replay has no song to chart and nothing new to record
+    const bool replayConflict = !ret.replayPath.empty() && (ret.chart || !ret.recordPath.empty());
+
+    if (ret.offscreenFrames < 1 || ret.offscreenFps <= 0.0f || ret.signalBpm <= 0.0 || ret.signalSeconds <= 0.0 || replayConflict)
+    {
+        printUsage(argv[0]);
+        return std::nullopt;
+    }
+
+    return ret;
+}
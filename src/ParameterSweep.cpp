@@ -0,0 +1,181 @@
+#include "ParameterSweep.h"
+
+#include "FileAudioSource.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+int threadCount(const int requested)
+{
+    return requested > 0 ? requested : int(std::max(std::thread::hardware_concurrency(), 1u));
+}
+
+// Runs work(i) for every i in [0, count) on the given number of threads
+template<typename Work>
+void parallelFor(const size_t count, const int threads, Work&& work)
+{
+    std::atomic<size_t> next{ 0 };
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&]() {
+            for (size_t i = next++; i < count; i = next++)
+            {
+                work(i);
+            }
+        });
+    }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+}  // namespace
+
+std::vector<double> detectBeats(const TrackFeatures& track, const BeatDetectorConfig& config, const float minBeatInterval)
+{
+    std::vector<BeatEvent> beats;
+
+    BeatDetector detector(config);
+    const std::vector<float>& energies = config.useBands ? track.bandEnergies : track.energies;
+    for (size_t i = 0; i < energies.size(); ++i)
+    {
+        if (const std::optional<BeatEvent> beat = detector.process(energies[i], track.samplePosition(i)))
+        {
+            beats.push_back(*beat);
+        }
+    }
+
+    OfflineAnalyser::mergeBeats(beats, track.sampleRate, minBeatInterval);
+
+    std::vector<double> ret;
+    ret.reserve(beats.size());
+    for (const BeatEvent& beat : beats)
+    {
+        ret.push_back(double(beat.samplePosition) / track.sampleRate);
+    }
+
+    return ret;
+}
+
+std::vector<SweepResult> runSweep(
+    const FeatureStore& store, const std::vector<std::vector<double>>& annotations, const SweepGrid& grid, const double tolerance, const float minBeatInterval, const int threads)
+{
+    std::vector<SweepResult> results;
+    for (const int history : grid.histories)
+    {
+        for (const float slope : grid.varianceSlopes)
+        {
+            for (const float base : grid.multiplierBases)
+            {
+                for (const bool bands : grid.useBands)
+                {
+                    SweepResult result;
+                    result.config.history = history;
+                    result.config.varianceSlope = slope;
+                    result.config.multiplierBase = base;
+                    result.config.useBands = bands;
+                    results.push_back(result);
+                }
+            }
+        }
+    }
+
+    const std::vector<TrackFeatures>& tracks = store.getTracks();
+    parallelFor(results.size(), threadCount(threads), [&](const size_t i) {
+        for (size_t track = 0; track < tracks.size() && track < annotations.size(); ++track)
+        {
+            results[i].score += scoreBeats(detectBeats(tracks[track], results[i].config, minBeatInterval), annotations[track], tolerance);
+        }
+    });
+
+    std::stable_sort(results.begin(), results.end(), [](const SweepResult& a, const SweepResult& b) { return a.score.fMeasure() > b.score.fMeasure(); });
+    return results;
+}
+
+int runSweepTool(const std::filesystem::path& folder, const std::filesystem::path& cache, const OfflineAnalysisConfig& config)
+{
+    const std::vector<std::filesystem::path> sounds = findAnnotatedSounds(folder);
+    std::vector<std::vector<double>> annotations;
+
+    if (sounds.empty())
+    {
+        std::cout << "No annotated sounds in " << folder << "\n";
+        return -1;
+    }
+
+    for (const std::filesystem::path& sound : sounds)
+    {
+        annotations.push_back(loadAnnotations(findAnnotations(sound)));
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    FeatureStore store;
+    bool cached = !cache.empty() && store.load(cache, config) && store.getTracks().size() == sounds.size();
+    for (size_t i = 0; cached && i < sounds.size(); ++i)
+    {
+        cached = store.getTracks()[i].isFrom(sounds[i]);
+    }
+
+    if (!cached)
+    {
+        FMOD::System* system = FileAudioSource::createDecodingSystem();
+        if (!system)
+        {
+            return -1;
+        }
+
+        const OfflineAnalyser analyser(config);
+        std::vector<TrackFeatures> tracks(sounds.size());
+        parallelFor(sounds.size(), threadCount(0), [&](const size_t i) {
+            FileAudioSource source(system, sounds[i].string());
+            if (source.isOpen())
+            {
+                tracks[i] = FeatureStore::compute(source, analyser, sounds[i].filename().string());
+                tracks[i].stamp(sounds[i]);
+            }
+        });
+
+        system->release();
+
+        store = FeatureStore();
+        for (TrackFeatures& track : tracks)
+        {
+            store.add(std::move(track));
+        }
+
+        if (!cache.empty())
+        {
+            store.save(cache, config);
+        }
+    }
+
+    const auto featuresDone = std::chrono::steady_clock::now();
+
+    const SweepGrid grid;
+    const std::vector<SweepResult> results = runSweep(store, annotations, grid, 0.07, config.minBeatInterval);
+
+    const auto sweepDone = std::chrono::steady_clock::now();
+
+    std::cout << sounds.size() << " sounds, features " << (cached ? "loaded" : "computed") << " in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(featuresDone - start).count() << " ms, " << results.size() << " configurations in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(sweepDone - featuresDone).count() << " ms\n";
+
+    for (size_t i = 0; i < results.size() && i < 10; ++i)
+    {
+        const SweepResult& result = results[i];
+        std::cout << "F " << result.score.fMeasure() << " P " << result.score.precision() << " R " << result.score.recall() << " | history "
+                  << result.config.history << ", slope " << result.config.varianceSlope << ", base " << result.config.multiplierBase
+                  << (result.config.useBands ? ", bands" : ", full spectrum") << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include "PcmRingBuffer.h"
+
+PcmRingBuffer::PcmRingBuffer(const int channelsArg, const int capacityArg, const uint64_t startPositionArg)
+    : channels(channelsArg)
+    , capacity(capacityArg)
+    , samples(size_t(channelsArg) * size_t(capacityArg), 0.0f)
+    , startPosition(startPositionArg)
+    , writePosition(startPositionArg)
+{
+}
+
+void PcmRingBuffer::write(const float* interleaved, const int frames)
+{
+    // Only the newest capacity frames can survive the write
+    const int skipped = frames > capacity ? frames - capacity : 0;
+    interleaved += size_t(skipped) * size_t(channels);
+    writePosition += skipped;
+
+    int index = int(writePosition % uint64_t(capacity));
+    for (int i = skipped; i < frames; ++i)
+    {
+        for (int c = 0; c < channels; ++c)
+        {
+            samples[size_t(c) * size_t(capacity) + size_t(index)] = *interleaved++;
+        }
+
+        if (++index == capacity)
+        {
+            index = 0;
+        }
+    }
+
+    writePosition += frames - skipped;
+}
+
+void PcmRingBuffer::writeSilence(const int frames)
+{
+    const int written = frames < capacity ? frames : capacity;
+    writePosition += frames - written;
+
+    int index = int(writePosition % uint64_t(capacity));
+    for (int i = 0; i < written; ++i)
+    {
+        for (int c = 0; c < channels; ++c)
+        {
+            samples[size_t(c) * size_t(capacity) + size_t(index)] = 0.0f;
+        }
+
+        if (++index == capacity)
+        {
+            index = 0;
+        }
+    }
+
+    writePosition += written;
+}
+
+PcmRingBuffer::Segments PcmRingBuffer::read(const int channel, const uint64_t position, const int frames) const
+{
+    const float* base = samples.data() + size_t(channel) * size_t(capacity);
+    const int start = int(position % uint64_t(capacity));
+
+    Segments ret;
+    ret.first = base + start;
+    ret.firstCount = frames < capacity - start ? frames : capacity - start;
+    ret.second = base;
+    ret.secondCount = frames - ret.firstCount;
+    return ret;
+}
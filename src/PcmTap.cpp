@@ -0,0 +1,110 @@
+#include "PcmTap.h"
+
+#include <algorithm>
+#include <cstring>
+
+PcmTap::PcmTap()
+    : queue(QUEUE_BLOCKS)
+{
+    queue.forEachSlot([](PcmBlock& block) { block.samples.resize(size_t(MAX_BLOCK_FRAMES) * MAX_CHANNELS); });
+}
+
+PcmTap::~PcmTap()
+{
+    detach();
+}
+
+FMOD_RESULT PcmTap::attach(FMOD::System* system, FMOD::Channel* channelArg, const int index)
+{
+    FMOD_DSP_DESCRIPTION description;
+    std::memset(&description, 0, sizeof(description));
+    description.pluginsdkversion = FMOD_PLUGIN_SDK_VERSION;
+    std::strncpy(description.name, "PCM tap", sizeof(description.name) - 1);
+    description.version = 1;
+    description.numinputbuffers = 1;
+    description.numoutputbuffers = 1;
+    description.read = readCallback;
+    description.userdata = this;
+
+    FMOD_RESULT result = system->createDSP(&description, &dsp);
+    if (result != FMOD_OK)
+    {
+        return result;
+    }
+
+    result = channelArg->addDSP(index, dsp);
+    if (result != FMOD_OK)
+    {
+        dsp->release();
+        dsp = nullptr;
+        return result;
+    }
+
+    channel = channelArg;
+    return FMOD_OK;
+}
+
+void PcmTap::detach()
+{
+    if (dsp == nullptr)
+    {
+        return;
+    }
+
+    if (channel)
+    {
+        channel->removeDSP(dsp);
+        channel = nullptr;
+    }
+    dsp->release();
+    dsp = nullptr;
+}
+
+FMOD_RESULT F_CALLBACK PcmTap::readCallback(FMOD_DSP_STATE* state, float* inBuffer, float* outBuffer, const unsigned int length, const int inChannels, int* outChannels)
+{
+    std::memcpy(outBuffer, inBuffer, sizeof(float) * length * size_t(inChannels));
+    *outChannels = inChannels;
+
+    void* userData = nullptr;
+    state->functions->getuserdata(state, &userData);
+
+    unsigned long long clock = 0;
+    unsigned int offset = 0;
+    unsigned int clockLength = 0;
+    state->functions->getclock(state, &clock, &offset, &clockLength);
+
+    if (userData)
+    {
+        static_cast<PcmTap*>(userData)->push(inBuffer, clock + offset, length, inChannels);
+    }
+
+    return FMOD_OK;
+}
+
+void PcmTap::push(const float* samples, const unsigned long long clock, const unsigned int length, const int channels)
+{
+    if (channels <= 0 || channels > MAX_CHANNELS)
+    {
+        return;
+    }
+
+    for (unsigned int done = 0; done < length;)
+    {
+        const int frames = int(std::min(length - done, (unsigned int)MAX_BLOCK_FRAMES));
+
+        PcmBlock* block = queue.beginPush();
+        if (block == nullptr)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        block->clock = clock + done;
+        block->channels = channels;
+        block->frames = frames;
+        std::memcpy(block->samples.data(), samples + size_t(done) * size_t(channels), sizeof(float) * size_t(frames) * size_t(channels));
+        queue.endPush();
+
+        done += frames;
+    }
+}
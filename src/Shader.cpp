@@ -2,116 +2,483 @@
 
 #include "gtc/type_ptr.hpp"
 
+#include <algorithm>
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <iterator>
+
+GLuint Shader::boundProgram = 0;
+std::filesystem::path Shader::binaryCacheFolder;
+
+namespace
+{
+bool isSampler(const GLenum type)
+{
+    switch (type)
+    {
+        case GL_SAMPLER_1D:
+        case GL_SAMPLER_2D:
+        case GL_SAMPLER_3D:
+        case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_2D_ARRAY:
+        case GL_SAMPLER_BUFFER:
+        case GL_INT_SAMPLER_BUFFER:
+        case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+            return true;
+        default:
+            return false;
+    }
+}
+}  // namespace
+
+std::string Shader::readSource(const std::filesystem::path& path)
+{
+    std::string code;
+
+    try
+    {
+        std::ifstream istream;
+
+        istream.open(path.string());
+        std::stringstream ss;
+        ss << istream.rdbuf();
+        istream.close();
+        code = ss.str();
+    } catch (std::ifstream::failure e)
+    {
+        std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
+    }
+
+    return code;
+}
 
 Shader::Shader(const std::filesystem::path& vertexPath, const std::filesystem::path& fragmentPath)
+    : Shader(ShaderSources{ readSource(vertexPath), readSource(fragmentPath) })
 {
-    std::string vertexCode;
-    std::string fragmentCode;
+}
 
-    const auto lambda = [](std::string& code, const std::filesystem::path& path) {
-        try
-        {
-            std::ifstream istream;
-
-            istream.open(path.string());
-            std::stringstream ss;
-            ss << istream.rdbuf();
-            istream.close();
-            code = ss.str();
-        } catch (std::ifstream::failure e)
-        {
-            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
-        }
-    };
+Shader::Shader(const ShaderSources& sources)
+{
+    PendingProgram build = startBuild(sources);
+    finishBuild(build);
 
-    lambda(vertexCode, vertexPath);
-    lambda(fragmentCode, fragmentPath);
+    // A broken program is kept as well, it draws nothing but the handles stay usable
+    ID = build.program;
 
-    GLuint vertex, fragment;
+    resolveUniforms();
+}
+
+Shader::PendingProgram Shader::startBuild(const ShaderSources& sources)
+{
+    if (!binaryCacheAvailable())
+    {
+        return compileSources(sources, 0);
+    }
+
+    const std::uint64_t key = binaryCacheKey(sources);
+
+    PendingProgram ret;
+    ret.program = loadBinary(key);
+    if (!ret.program)
+    {
+        return compileSources(sources, key);
+    }
+
+    ret.cacheKey = key;
+    ret.fromCache = true;
+    ret.sources = sources;
+    return ret;
+}
+
+Shader::PendingProgram Shader::compileSources(const ShaderSources& sources, const std::uint64_t cacheKey)
+{
+    PendingProgram ret;
+    ret.cacheKey = cacheKey;
+
+    const char* vertexCodeChar = sources.vertex.c_str();
+    const char* fragmentCodeChar = sources.fragment.c_str();
+
+    ret.vertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(ret.vertex, 1, &vertexCodeChar, nullptr);
+    glCompileShader(ret.vertex);
+
+    ret.fragment = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(ret.fragment, 1, &fragmentCodeChar, nullptr);
+    glCompileShader(ret.fragment);
+
+    ret.program = glCreateProgram();
+    if (cacheKey)
+    {
+        glProgramParameteri(ret.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    glAttachShader(ret.program, ret.vertex);
+    glAttachShader(ret.program, ret.fragment);
+    glLinkProgram(ret.program);
+
+    return ret;
+}
+
+bool Shader::finishBuild(PendingProgram& build)
+{
     int success;
     char infoLog[512];
 
-    const char* vertexCodeChar = vertexCode.c_str();
-    const char* fragmentCodeChar = fragmentCode.c_str();
+    if (build.fromCache)
+    {
+        glGetProgramiv(build.program, GL_LINK_STATUS, &success);
+        if (success)
+        {
+            return true;
+        }
 
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vertexCodeChar, nullptr);
-    glCompileShader(vertex);
+        // Usually a driver update, the binary gets replaced by the one compiled now
+        glDeleteProgram(build.program);
+        build = compileSources(build.sources, build.cacheKey);
+    }
 
-    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
+    glGetShaderiv(build.vertex, GL_COMPILE_STATUS, &success);
     if (!success)
     {
-        glGetShaderInfoLog(vertex, 512, NULL, infoLog);
+        glGetShaderInfoLog(build.vertex, 512, NULL, infoLog);
         std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
     };
 
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fragmentCodeChar, nullptr);
-    glCompileShader(fragment);
-
-    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
+    glGetShaderiv(build.fragment, GL_COMPILE_STATUS, &success);
     if (!success)
     {
-        glGetShaderInfoLog(fragment, 512, NULL, infoLog);
+        glGetShaderInfoLog(build.fragment, 512, NULL, infoLog);
         std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
     };
 
-    ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
-    glLinkProgram(ID);
-
-    glGetProgramiv(ID, GL_LINK_STATUS, &success);
+    glGetProgramiv(build.program, GL_LINK_STATUS, &success);
     if (!success)
     {
-        glGetProgramInfoLog(ID, 512, NULL, infoLog);
+        glGetProgramInfoLog(build.program, 512, NULL, infoLog);
         std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
     };
 
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+    glDeleteShader(build.vertex);
+    glDeleteShader(build.fragment);
+    build.vertex = 0;
+    build.fragment = 0;
+
+    if (success && build.cacheKey)
+    {
+        storeBinary(build.program, build.cacheKey);
+    }
+
+    return success != 0;
+}
+
+void Shader::setBinaryCacheFolder(const std::filesystem::path& folder)
+{
+    std::error_code error;
+    std::filesystem::create_directories(folder, error);
+    if (error)
+    {
+        std::cout << "ERROR::SHADER::BINARY_CACHE_FOLDER_NOT_CREATED " << folder.string() << std::endl;
+        return;
+    }
+
+    binaryCacheFolder = folder;
+}
+
+bool Shader::binaryCacheAvailable()
+{
+    if (binaryCacheFolder.empty() || !GLAD_GL_VERSION_4_1)
+    {
+        return false;
+    }
+
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+std::uint64_t Shader::binaryCacheKey(const ShaderSources& sources)
+{
+    // FNV-1a, std::hash is not guaranteed to be stable between runs
+    std::uint64_t hash = 14695981039346656037ull;
+    const auto append = [&hash](const char* data) {
+        for (; data && *data; ++data)
+        {
+            hash ^= std::uint8_t(*data);
+            hash *= 1099511628211ull;
+        }
+        hash ^= 0xff;
+        hash *= 1099511628211ull;
+    };
+
+    append(sources.vertex.c_str());
+    append(sources.fragment.c_str());
+    append(reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+    append(reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    append(reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+
+    return hash;
+}
+
+std::filesystem::path Shader::binaryCachePath(const std::uint64_t key)
+{
+    std::stringstream ss;
+    ss << std::hex << key << ".bin";
+    return binaryCacheFolder / ss.str();
+}
+
+GLuint Shader::loadBinary(const std::uint64_t key)
+{
+    std::ifstream file(binaryCachePath(key), std::ios::binary);
+    if (!file)
+    {
+        return 0;
+    }
+
+    GLenum format = 0;
+    file.read(reinterpret_cast<char*>(&format), sizeof(format));
+    if (!file)
+    {
+        return 0;
+    }
+
+    const std::vector<char> binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (binary.empty())
+    {
+        return 0;
+    }
+
+    const GLuint program = glCreateProgram();
+    glProgramBinary(program, format, binary.data(), GLsizei(binary.size()));
+    return program;
+}
+
+void Shader::storeBinary(const GLuint program, const std::uint64_t key)
+{
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+    {
+        return;
+    }
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, nullptr, &format, binary.data());
+
+    // Written next to the final name and renamed, so a crash never leaves half a binary behind
+    const std::filesystem::path path = binaryCachePath(key);
+    std::filesystem::path temporary = path;
+    temporary += ".tmp";
+
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&format), sizeof(format));
+        file.write(binary.data(), std::streamsize(binary.size()));
+        if (!file)
+        {
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+}
+
+void Shader::beginReload(const ShaderSources& sources)
+{
+    if (pending.program)
+    {
+        finishReload();
+    }
+
+    pending = startBuild(sources);
+}
+
+bool Shader::finishReload()
+{
+    if (!pending.program)
+    {
+        return false;
+    }
+
+    const bool success = finishBuild(pending);
+    if (!success)
+    {
+        // Keep drawing with the last working program
+        glDeleteProgram(pending.program);
+        pending = PendingProgram{};
+        return false;
+    }
+
+    if (boundProgram == ID)
+    {
+        boundProgram = 0;
+    }
+    glDeleteProgram(ID);
+
+    ID = pending.program;
+    pending = PendingProgram{};
+
+    resolveUniforms();
+    return true;
+}
+
+Shader::~Shader()
+{
+    if (pending.program)
+    {
+        glDeleteShader(pending.vertex);
+        glDeleteShader(pending.fragment);
+        glDeleteProgram(pending.program);
+    }
+
+    if (boundProgram == ID)
+    {
+        boundProgram = 0;
+    }
+
+    glDeleteProgram(ID);
+}
+
+void Shader::resolveUniforms()
+{
+    // Handles index this table, so after a reload known uniforms keep their slot and only get a new location
+    for (UniformInfo& info : uniforms)
+    {
+        info.location = -1;
+    }
+
+    GLint count = 0;
+    GLint maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::vector<char> nameBuffer(std::max(maxLength, 1));
+    for (GLint i = 0; i < count; ++i)
+    {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, GLuint(i), GLsizei(nameBuffer.size()), &length, &size, &type, nameBuffer.data());
+
+        std::string name(nameBuffer.data(), size_t(length));
+
+        // Arrays are reported as "name[0]", they are looked up by their plain name
+        const size_t bracket = name.find('[');
+        if (bracket != std::string::npos)
+        {
+            name.erase(bracket);
+        }
+
+        // Members of uniform blocks have no location, they are not set through the table
+        const GLint location = glGetUniformLocation(ID, name.c_str());
+        if (location < 0)
+        {
+            continue;
+        }
+
+        const auto existing = std::find_if(uniforms.begin(), uniforms.end(), [&name](const UniformInfo& info) { return info.name == name; });
+        if (existing != uniforms.end())
+        {
+            existing->location = location;
+            existing->type = type;
+        }
+        else
+        {
+            uniforms.push_back({ std::move(name), location, type });
+        }
+    }
+}
+
+int Shader::findUniform(const std::string& name, const GLenum type) const
+{
+    for (int i = 0; i < int(uniforms.size()); ++i)
+    {
+        if (uniforms[i].name != name)
+        {
+            continue;
+        }
+
+        const bool typeMatches = type == 0 || uniforms[i].type == type || (type == GL_INT && isSampler(uniforms[i].type));
+        if (!typeMatches)
+        {
+            std::cout << "ERROR::SHADER::UNIFORM_TYPE_MISMATCH " << name << std::endl;
+            return -1;
+        }
+
+        return i;
+    }
+
+    return -1;
+}
+
+void Shader::set(const Uniform<bool> uniform, const bool value) const
+{
+    glUniform1i(location(uniform.index), (int)value);
+}
+
+void Shader::set(const Uniform<int> uniform, const int value) const
+{
+    glUniform1i(location(uniform.index), value);
+}
+
+void Shader::set(const Uniform<float> uniform, const float value) const
+{
+    glUniform1f(location(uniform.index), value);
+}
+
+void Shader::set(const Uniform<glm::mat4> uniform, const glm::mat4& mat) const
+{
+    glUniformMatrix4fv(location(uniform.index), 1, GL_FALSE, glm::value_ptr(mat));
+}
+
+void Shader::set(const Uniform<glm::vec3> uniform, const glm::vec3& vec) const
+{
+    glUniform3fv(location(uniform.index), 1, &vec[0]);
+}
+
+void Shader::set(const Uniform<glm::vec2> uniform, const glm::vec2& vec) const
+{
+    glUniform2fv(location(uniform.index), 1, &vec[0]);
 }
 
 void Shader::setBool(const std::string& name, const bool value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+    glUniform1i(location(findUniform(name, 0)), (int)value);
 }
 
 void Shader::setInt(const std::string& name, const int value) const
 {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1i(location(findUniform(name, 0)), value);
 }
 
 void Shader::setFloat(const std::string& name, const float value) const
 {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1f(location(findUniform(name, 0)), value);
 }
 
 void Shader::setMat4(const std::string& name, const glm::mat4& mat) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+    glUniformMatrix4fv(location(findUniform(name, 0)), 1, GL_FALSE, glm::value_ptr(mat));
 }
 
 void Shader::setVec3(const std::string& name, const float x, const float y, const float z) const
 {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+    glUniform3f(location(findUniform(name, 0)), x, y, z);
 }
 
 void Shader::setVec3(const std::string& name, const glm::vec3& vec) const
 {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &vec[0]);
+    glUniform3fv(location(findUniform(name, 0)), 1, &vec[0]);
 }
 
 void Shader::setVec2(const std::string& name, const float x, const float y) const
 {
-    glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+    glUniform2f(location(findUniform(name, 0)), x, y);
 }
 
 void Shader::setVec2(const std::string& name, const glm::vec2& vec) const
 {
-    glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &vec[0]);
-}
\ No newline at end of file
+    glUniform2fv(location(findUniform(name, 0)), 1, &vec[0]);
+}
@@ -0,0 +1,197 @@
+#include "ShaderManager.h"
+
+#include <chrono>
+#include <iostream>
+#include <system_error>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+ShaderManager::ShaderManager(const std::filesystem::path& folderArg)
+    : folder(folderArg)
+{
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(folder, error))
+    {
+        if (entry.is_regular_file(error))
+        {
+            sources[entry.path().filename().string()] = Shader::readSource(entry.path());
+        }
+    }
+
+    watcher = std::thread(&ShaderManager::watch, this);
+}
+
+ShaderManager::~ShaderManager()
+{
+    running = false;
+    if (watcher.joinable())
+    {
+        watcher.join();
+    }
+}
+
+Shader& ShaderManager::get(const std::string& vertexName, const std::string& fragmentName)
+{
+    for (const Program& program : programs)
+    {
+        if (program.vertexName == vertexName && program.fragmentName == fragmentName)
+        {
+            return *program.shader;
+        }
+    }
+
+    for (const std::string& name : { vertexName, fragmentName })
+    {
+        if (sources.find(name) == sources.end())
+        {
+            sources[name] = Shader::readSource(folder / name);
+        }
+    }
+
+    programs.push_back({ vertexName, fragmentName, std::make_unique<Shader>(ShaderSources{ sources[vertexName], sources[fragmentName] }) });
+    return *programs.back().shader;
+}
+
+void ShaderManager::update()
+{
+    // Programs issued last frame had a whole frame to compile in the driver
+    for (const Program& program : programs)
+    {
+        if (program.shader->isReloading() && program.shader->finishReload())
+        {
+            std::cout << "Reloaded " << program.vertexName << " + " << program.fragmentName << "\n";
+        }
+    }
+
+    std::map<std::string, std::string> changed;
+    {
+        std::lock_guard<std::mutex> lock(changedMutex);
+        changed.swap(changedSources);
+    }
+
+    if (changed.empty())
+    {
+        return;
+    }
+
+    for (auto& [name, code] : changed)
+    {
+        sources[name] = std::move(code);
+    }
+
+    for (const Program& program : programs)
+    {
+        if (changed.count(program.vertexName) || changed.count(program.fragmentName))
+        {
+            program.shader->beginReload(ShaderSources{ sources[program.vertexName], sources[program.fragmentName] });
+        }
+    }
+}
+
+void ShaderManager::releasePrograms()
+{
+    programs.clear();
+}
+
+void ShaderManager::readChanged(const std::string& name)
+{
+    std::string code = Shader::readSource(folder / name);
+
+    // Editors may truncate the file before writing it, the next event brings the content
+    if (code.empty())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(changedMutex);
+    changedSources[name] = std::move(code);
+}
+
+#if defined(__linux__)
+
+void ShaderManager::watch()
+{
+    const int fd = inotify_init1(IN_NONBLOCK);
+    if (fd < 0 || inotify_add_watch(fd, folder.string().c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        std::cout << "ERROR::SHADER_MANAGER::WATCH_FAILED" << std::endl;
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return;
+    }
+
+    alignas(inotify_event) char buffer[4096];
+
+    while (running)
+    {
+        pollfd descriptor{ fd, POLLIN, 0 };
+        if (poll(&descriptor, 1, 100) <= 0)
+        {
+            continue;
+        }
+
+        const ssize_t length = read(fd, buffer, sizeof(buffer));
+        for (ssize_t offset = 0; offset < length;)
+        {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            if (event->len > 0)
+            {
+                readChanged(event->name);
+            }
+            offset += ssize_t(sizeof(inotify_event) + event->len);
+        }
+    }
+
+    close(fd);
+}
+
+#else
+
+void ShaderManager::watch()
+{
+    std::map<std::string, std::filesystem::file_time_type> writeTimes;
+
+    const auto scan = [this, &writeTimes](const bool notify) {
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(folder, error))
+        {
+            if (!entry.is_regular_file(error))
+            {
+                continue;
+            }
+
+            const std::string name = entry.path().filename().string();
+            const auto writeTime = entry.last_write_time(error);
+            if (error)
+            {
+                continue;
+            }
+
+            const auto known = writeTimes.find(name);
+            if (known == writeTimes.end() || known->second != writeTime)
+            {
+                writeTimes[name] = writeTime;
+                if (notify)
+                {
+                    readChanged(name);
+                }
+            }
+        }
+    };
+
+    scan(false);
+
+    while (running)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        scan(true);
+    }
+}
+
+#endif
@@ -0,0 +1,266 @@
+#include "SignalGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr double PI = 3.14159265358979323846;
+
+// Counter based white noise in [-1, 1), the same index always gives the same value
+float whiteNoise(const uint32_t seed, const uint64_t index)
+{
+    uint64_t x = index * 0x9e3779b97f4a7c15ull + seed;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return float(x >> 40) / float(1 << 23) - 1.0f;
+}
+
+std::vector<float> renderInstrument(const Instrument instrument, const int sampleRate, const uint32_t seed)
+{
+    std::vector<float> ret;
+
+    const double seconds = instrument == Instrument::Click ? 0.02 : instrument == Instrument::Kick ? 0.35 : instrument == Instrument::Snare ? 0.2 : 0.06;
+    ret.resize(size_t(seconds * sampleRate));
+
+    float previousNoise{ 0.0f };
+    for (size_t i = 0; i < ret.size(); ++i)
+    {
+        const double t = double(i) / sampleRate;
+        const float noise = whiteNoise(seed + 1 + uint32_t(instrument), i);
+
+        switch (instrument)
+        {
+            case Instrument::Click:
+                ret[i] = float(std::exp(-t / 0.004) * std::sin(2.0 * PI * 1000.0 * t));
+                break;
+            case Instrument::Kick:
+                // Pitch falls from 150 Hz to 50 Hz, the phase is the integral of that
+                ret[i] = float(std::exp(-t / 0.12) * std::sin(2.0 * PI * (50.0 * t + 100.0 * 0.03 * (1.0 - std::exp(-t / 0.03)))));
+                break;
+            case Instrument::Snare:
+                ret[i] = float(0.5 * std::exp(-t / 0.05) * std::sin(2.0 * PI * 185.0 * t) + 0.6 * std::exp(-t / 0.06) * noise);
+                break;
+            case Instrument::HiHat:
+                // First difference of the noise leaves mostly the top of the spectrum
+                ret[i] = float(0.5 * std::exp(-t / 0.015) * (noise - previousNoise));
+                break;
+        }
+
+        previousNoise = noise;
+    }
+
+    return ret;
+}
+}  // namespace
+
+SignalGenerator::SignalGenerator(const SignalGeneratorConfig& configArg)
+    : config(configArg)
+{
+    config.sampleRate = std::max(config.sampleRate, 1);
+    config.channels = std::max(config.channels, 1);
+    config.bpm = std::max(config.bpm, 1.0);
+
+    length = uint64_t(std::max(config.seconds, 0.0) * config.sampleRate);
+    sixteenthSeconds = 60.0 / config.bpm / 4.0;
+
+    for (const DrumHit& hit : config.pattern)
+    {
+        std::vector<float>& table = instruments[size_t(hit.instrument)];
+        if (table.empty())
+        {
+            table = renderInstrument(hit.instrument, config.sampleRate, config.seed);
+            longestInstrument = std::max(longestInstrument, table.size());
+        }
+    }
+}
+
+SignalGeneratorConfig SignalGenerator::clickTrack(const double bpm, const double seconds)
+{
+    SignalGeneratorConfig ret;
+    ret.bpm = bpm;
+    ret.seconds = seconds;
+    ret.pattern = { { 0, Instrument::Click }, { 4, Instrument::Click }, { 8, Instrument::Click }, { 12, Instrument::Click } };
+    return ret;
+}
+
+SignalGeneratorConfig SignalGenerator::drumLoop(const double bpm, const float swing, const double seconds)
+{
+    SignalGeneratorConfig ret;
+    ret.bpm = bpm;
+    ret.seconds = seconds;
+    ret.swing = swing;
+    ret.pattern = { { 0, Instrument::Kick, 0.7f }, { 4, Instrument::Snare, 0.6f }, { 8, Instrument::Kick, 0.7f }, { 12, Instrument::Snare, 0.6f } };
+    for (int step = 0; step < 16; ++step)
+    {
+        ret.pattern.push_back({ step, Instrument::HiHat, step % 2 == 0 ? 0.25f : 0.15f });
+    }
+    return ret;
+}
+
+std::optional<SignalGeneratorConfig> SignalGenerator::preset(const std::string& name, const double bpm, const double seconds)
+{
+    if (name == "click")
+    {
+        return clickTrack(bpm, seconds);
+    }
+    if (name == "drums")
+    {
+        return drumLoop(bpm, 0.0f, seconds);
+    }
+    if (name == "swing")
+    {
+        return drumLoop(bpm, 1.0f / 3.0f, seconds);
+    }
+    if (name == "noise")
+    {
+        SignalGeneratorConfig ret = drumLoop(bpm, 0.0f, seconds);
+        ret.noise = 0.1f;
+        return ret;
+    }
+    if (name == "sweep")
+    {
+        SignalGeneratorConfig ret;
+        ret.bpm = bpm;
+        ret.seconds = seconds;
+        ret.sweep = 0.5f;
+        return ret;
+    }
+
+    return std::nullopt;
+}
+
+std::vector<double> SignalGenerator::getBeats() const
+{
+    std::vector<double> ret;
+    for (double time = config.firstBeat; time < config.seconds; time += 4.0 * sixteenthSeconds)
+    {
+        ret.push_back(time);
+    }
+    return ret;
+}
+
+std::vector<double> SignalGenerator::getOnsets() const
+{
+    std::vector<double> ret;
+    if (config.pattern.empty())
+    {
+        return ret;
+    }
+
+    for (int64_t bar = 0;; ++bar)
+    {
+        bool inside = false;
+        for (const DrumHit& hit : config.pattern)
+        {
+            const int64_t frame = hitFrame(bar, hit);
+            if (frame < int64_t(length))
+            {
+                ret.push_back(double(frame) / config.sampleRate);
+                inside = true;
+            }
+        }
+
+        if (!inside)
+        {
+            break;
+        }
+    }
+
+    std::sort(ret.begin(), ret.end());
+    ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+    return ret;
+}
+
+int SignalGenerator::read(float* interleaved, const int frames)
+{
+    const int count = int(std::min<uint64_t>(uint64_t(std::max(frames, 0)), length - position));
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    mono.assign(size_t(count), 0.0f);
+    render(mono.data(), count);
+
+    const int channels = config.channels;
+    for (int i = 0; i < count; ++i)
+    {
+        for (int c = 0; c < channels; ++c)
+        {
+            interleaved[i * channels + c] = mono[i];
+        }
+    }
+
+    position += uint64_t(count);
+    return count;
+}
+
+bool SignalGenerator::seek(const uint64_t frame)
+{
+    position = std::min(frame, length);
+    return true;
+}
+
+int64_t SignalGenerator::hitFrame(const int64_t bar, const DrumHit& hit) const
+{
+    const double swing = hit.step % 2 == 1 ? config.swing : 0.0;
+    const double time = config.firstBeat + (double(bar * 16 + hit.step) + swing) * sixteenthSeconds;
+    return int64_t(std::llround(time * config.sampleRate));
+}
+
+void SignalGenerator::render(float* out, const int count) const
+{
+    const int64_t begin = int64_t(position);
+    const int64_t end = begin + count;
+
+    if (config.noise > 0.0f)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            out[i] += config.noise * whiteNoise(config.seed, uint64_t(begin + i));
+        }
+    }
+
+    if (config.sweep > 0.0f && length > 0)
+    {
+        // Exponential sweep, the phase is the integral of f0 * (f1 / f0) ^ (t / T)
+        const double duration = double(length) / config.sampleRate;
+        const double rate = std::log(double(config.sweepEnd) / config.sweepStart) / duration;
+        for (int i = 0; i < count; ++i)
+        {
+            const double t = double(begin + i) / config.sampleRate;
+            const double phase = 2.0 * PI * config.sweepStart * (std::exp(rate * t) - 1.0) / rate;
+            out[i] += float(config.sweep * std::sin(phase));
+        }
+    }
+
+    if (config.pattern.empty())
+    {
+        return;
+    }
+
+    // Bars that have a hit still sounding somewhere in [begin, end)
+    const double barSeconds = 16.0 * sixteenthSeconds;
+    const double earliest = double(begin - int64_t(longestInstrument)) / config.sampleRate - config.firstBeat;
+    const double latest = double(end) / config.sampleRate - config.firstBeat;
+    const int64_t firstBar = std::max<int64_t>(int64_t(std::floor(earliest / barSeconds)) - 1, 0);
+    const int64_t lastBar = int64_t(std::floor(latest / barSeconds));
+
+    for (int64_t bar = firstBar; bar <= lastBar; ++bar)
+    {
+        for (const DrumHit& hit : config.pattern)
+        {
+            const std::vector<float>& table = instruments[size_t(hit.instrument)];
+            const int64_t start = hitFrame(bar, hit);
+            const int64_t from = std::max(start, begin);
+            const int64_t to = std::min(start + int64_t(table.size()), end);
+
+            for (int64_t frame = from; frame < to; ++frame)
+            {
+                out[frame - begin] += hit.gain * table[size_t(frame - start)];
+            }
+        }
+    }
+}
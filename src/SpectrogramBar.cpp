@@ -1,9 +1,9 @@
 #include "SpectrogramBar.h"
 
 #include "Shader.h"
-#include "Utilities.h"
 
 Shader* SpectrogramBar::shader = nullptr;
+Uniform<bool> SpectrogramBar::isRedUniform;
 
 SpectrogramBar::SpectrogramBar(const float xPos, const float yPos, const float widthArg, const float heightArg)
     : xCoordBottomLeft(xPos)
@@ -11,11 +11,6 @@ SpectrogramBar::SpectrogramBar(const float xPos, const float yPos, const float w
     , width(widthArg)
     , height(heightArg)
 {
-    if (!shader)
-    {
-        shader = new Shader(getShaderPath("bar.vs"), getShaderPath("bar.fs"));
-    }
-
     const float xNDC = xCoordBottomLeft * 2 - 1;
     const float yNDC = yCoordBottomLeft * 2 - 1;
     const float widthNDC = width * 2;
@@ -50,6 +45,12 @@ SpectrogramBar::SpectrogramBar(const float xPos, const float yPos, const float w
     glEnableVertexAttribArray(0);
 }
 
+void SpectrogramBar::setShader(Shader& shaderArg)
+{
+    shader = &shaderArg;
+    isRedUniform = shader->getUniform<bool>("isRed");
+}
+
 SpectrogramBar::SpectrogramBar(SpectrogramBar&& rhs) noexcept
     : xCoordBottomLeft(rhs.xCoordBottomLeft)
     , yCoordBottomLeft(rhs.yCoordBottomLeft)
@@ -94,9 +95,8 @@ SpectrogramBar::~SpectrogramBar()
 
 void SpectrogramBar::draw() const
 {
-    glUseProgram(shader->getID());
-
-    shader->setBool("isRed", height > 0.5f);
+    shader->use();
+    shader->set(isRedUniform, height > 0.5f);
 
     glBindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES, GLsizei(vertices.size()), GL_UNSIGNED_INT, 0);
@@ -0,0 +1,190 @@
+#include "SpectrumAnalysis.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+int firstChannel(const int channel)
+{
+    return channel == ALL_CHANNELS ? 0 : channel;
+}
+
+int lastChannel(const SpectrumFrame& frame, const int channel)
+{
+    return channel == ALL_CHANNELS ? frame.numChannels : channel + 1;
+}
+}  // namespace
+
+std::vector<float> logBucketLimits(const int buckets)
+{
+    std::vector<float> limits;
+    limits.resize(buckets);
+
+    const float mult = buckets / 12.0f;  // magic
+
+    for (int i = 0; i < buckets; ++i)
+    {
+        const float curr = (44100.0f / 2) * pow(0.5f + 0.41f * (1 - exp(-1 * (mult - 1))), i + 1);  // magic
+        limits[i] = curr;
+    }
+
+    std::reverse(limits.begin(), limits.end());
+
+    return limits;
+}
+
+void fillCountsLinear(std::vector<float>& counts, const SpectrumFrame& frame, const int channel)
+{
+    const int bins = frame.bins();
+    const int bucketsize = (bins / int(counts.size())) + 1;  // round up
+
+    for (int c = firstChannel(channel); c < lastChannel(frame, channel); ++c)
+    {
+        const float* spectrum = frame.channel(c);
+        for (int i = 0; i < bins; ++i)
+        {
+            const int currentBucket = i / bucketsize;
+            const float val = spectrum[i];
+
+            counts[currentBucket] += val;
+        }
+    }
+}
+
+void fillCountsLog(std::vector<float>& counts, const SpectrumFrame& frame, const int channel)
+{
+    const std::vector<float> limits = logBucketLimits(int(counts.size()));
+
+    const int bins = frame.bins();
+    for (int c = firstChannel(channel); c < lastChannel(frame, channel); ++c)
+    {
+        const float* spectrum = frame.channel(c);
+        for (int i = 0; i < bins; ++i)
+        {
+            const float currentFreq = (44100.0f / 2) * (float(i) / bins);
+
+            if (currentFreq > limits[limits.size() - 1])
+            {
+                counts[counts.size() - 1] += spectrum[i];
+            }
+            else
+            {
+                for (size_t j = 0; j < limits.size() - 1; ++j)
+                {
+                    if (currentFreq < limits[j + size_t(1)])
+                    {
+                        counts[j] += spectrum[i];
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+std::vector<float> bucketCentreFrequencies(const int buckets, const int bins, const bool logarithmic)
+{
+    std::vector<float> ret;
+    ret.reserve(buckets);
+
+    if (logarithmic)
+    {
+        // Same edges fillCountsLog uses, the first bucket reaches down to DC and the last one up to Nyquist
+        const std::vector<float> limits = logBucketLimits(buckets);
+        for (int i = 0; i < buckets; ++i)
+        {
+            const float low = i == 0 ? limits[std::min(1, buckets - 1)] * 0.5f : limits[i];
+            const float high = i + 1 < buckets ? limits[i + 1] : 44100.0f / 2;
+            ret.push_back(std::sqrt(low * high));
+        }
+    }
+    else
+    {
+        const int bucketsize = (bins / buckets) + 1;
+        for (int i = 0; i < buckets; ++i)
+        {
+            ret.push_back((44100.0f / 2) * ((i + 0.5f) * bucketsize / bins));
+        }
+    }
+
+    return ret;
+}
+
+std::vector<float> binFrequencies(const int bins)
+{
+    std::vector<float> ret;
+    ret.reserve(bins);
+
+    for (int i = 0; i < bins; ++i)
+    {
+        ret.push_back((44100.0f / 2) * (float(i) / bins));
+    }
+
+    return ret;
+}
+
+float calculateSoundEnergy(const SpectrumFrame& frame, const int channel)
+{
+    float ret{ 0.0f };
+
+    const int bins = frame.bins();
+    for (int c = firstChannel(channel); c < lastChannel(frame, channel); ++c)
+    {
+        const float* spectrum = frame.channel(c);
+        for (int i = 0; i < bins; ++i)
+        {
+            ret += spectrum[i] * spectrum[i];
+        }
+    }
+
+    return ret;
+}
+
+float calculateSoundEnergyInBands(const SpectrumFrame& frame, const std::vector<std::pair<float, float>>& bands, const int channel)
+{
+    float ret{ 0.0f };
+
+    const int bins = frame.bins();
+    for (int c = firstChannel(channel); c < lastChannel(frame, channel); ++c)
+    {
+        const float* spectrum = frame.channel(c);
+        for (int i = 0; i < bins; ++i)
+        {
+            const float currentFreq = (44100.0f / 2) * (float(i) / bins);
+
+            bool foundInBand = false;
+            for (int band = 0; band < bands.size(); ++band)
+            {
+                if (currentFreq >= bands[band].first && currentFreq <= bands[band].second)
+                {
+                    foundInBand = true;
+                    break;
+                }
+            }
+
+            if (!foundInBand)
+            {
+                continue;
+            }
+
+            ret += spectrum[i] * spectrum[i];
+        }
+    }
+
+    return ret;
+}
+
+float calculateEnergyVariance(const std::vector<float>& energies, const float average)
+{
+    float ret{ 0.0f };
+
+    for (int i = 0; i < energies.size(); ++i)
+    {
+        ret += (energies[i] - average) * (energies[i] - average);
+    }
+
+    ret *= 1 / float(energies.size());
+
+    return ret;
+}
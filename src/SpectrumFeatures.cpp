@@ -0,0 +1,209 @@
+#include "SpectrumFeatures.h"
+
+#include "FastMath.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr int CHUNK_BINS = 256;  // 1 KB of spectrum
+
+// Smallest power the flatness takes the logarithm of, silence would be -inf otherwise
+constexpr float MIN_POWER = 1e-20f;
+}  // namespace
+
+FeatureKernel::FeatureKernel(const FeatureKernelConfig& configArg, const Filterbank* filterbankArg)
+    : config(configArg)
+    , filterbank(filterbankArg)
+{
+    config.bins = std::max(config.bins, 1);
+    chunks = (config.bins + CHUNK_BINS - 1) / CHUNK_BINS;
+    chunkPower.resize(size_t(chunks));
+
+    // Same bin frequencies and inclusive limits as calculateSoundEnergyInBands
+    const auto frequencyOf = [&](const int bin) { return (config.sampleRate / 2) * (float(bin) / config.bins); };
+
+    for (const auto& band : config.bands)
+    {
+        BinRange range{ config.bins, config.bins };
+        for (int i = 0; i < config.bins; ++i)
+        {
+            const float frequency = frequencyOf(i);
+            if (frequency >= band.first && frequency <= band.second)
+            {
+                range.first = std::min(range.first, i);
+                range.end = i + 1;
+            }
+        }
+        bandRanges.push_back(range.first < range.end ? range : BinRange{});
+    }
+
+    for (int i = 0; i < config.bins; ++i)
+    {
+        const float frequency = frequencyOf(i);
+        const bool inBand = std::any_of(
+            config.bands.begin(), config.bands.end(), [&](const std::pair<float, float>& band) { return frequency >= band.first && frequency <= band.second; });
+        if (!inBand)
+        {
+            continue;
+        }
+
+        if (!unionRanges.empty() && unionRanges.back().end == i)
+        {
+            ++unionRanges.back().end;
+        }
+        else
+        {
+            unionRanges.push_back({ i, i + 1 });
+        }
+    }
+
+    chunkRowStart.assign(size_t(chunks) + 1, 0);
+    if (filterbank && filterbank->getConfig().bins == config.bins)
+    {
+        const int buckets = filterbank->getConfig().buckets;
+
+        std::vector<int> chunkOfRow(buckets);
+        for (int bucket = 0; bucket < buckets; ++bucket)
+        {
+            const int lastBin = filterbank->getRowFirstBin(bucket) + std::max(filterbank->getRowSize(bucket), 1) - 1;
+            chunkOfRow[bucket] = std::clamp(lastBin / CHUNK_BINS, 0, chunks - 1);
+            ++chunkRowStart[chunkOfRow[bucket] + 1];
+        }
+        for (int chunk = 0; chunk < chunks; ++chunk)
+        {
+            chunkRowStart[chunk + 1] += chunkRowStart[chunk];
+        }
+
+        chunkRows.resize(size_t(buckets));
+        std::vector<int> fill(chunkRowStart.begin(), chunkRowStart.end() - 1);
+        for (int bucket = 0; bucket < buckets; ++bucket)
+        {
+            chunkRows[fill[chunkOfRow[bucket]]++] = bucket;
+        }
+    }
+    else
+    {
+        filterbank = nullptr;
+    }
+}
+
+bool FeatureKernel::process(const SpectrumFrame& frame, SpectrumFeatures& features, const int channel)
+{
+    if (frame.bins() != config.bins)
+    {
+        return false;
+    }
+
+    const int bins = config.bins;
+    const int firstChannel = channel == ALL_CHANNELS ? 0 : channel;
+    const int lastChannel = channel == ALL_CHANNELS ? frame.numChannels : channel + 1;
+
+    features.buckets.assign(filterbank ? size_t(filterbank->getConfig().buckets) : 0, 0.0f);
+    features.bandEnergies.assign(bandRanges.size(), 0.0f);
+    std::fill(chunkPower.begin(), chunkPower.end(), 0.0f);
+
+    float energy{ 0.0f };
+    float bandEnergy{ 0.0f };
+    float weightedBins{ 0.0f };
+    float logSum{ 0.0f };
+
+    for (int c = firstChannel; c < lastChannel; ++c)
+    {
+        const float* spectrum = frame.channel(c);
+        size_t unionRange = 0;
+
+        for (int chunk = 0; chunk < chunks; ++chunk)
+        {
+            const int chunkFirst = chunk * CHUNK_BINS;
+            const int chunkEnd = std::min(chunkFirst + CHUNK_BINS, bins);
+
+            float power{ 0.0f };
+            for (int i = chunkFirst; i < chunkEnd; ++i)
+            {
+                // Written like calculateSoundEnergy, so the compiler contracts it the same way
+                energy += spectrum[i] * spectrum[i];
+
+                const float square = spectrum[i] * spectrum[i];
+                power += square;
+                weightedBins += float(i) * square;
+                logSum += fastLog2(std::max(square, MIN_POWER));
+            }
+            chunkPower[chunk] += power;
+
+            // The chunk is in cache now, everything else that needs its bins reads them again from there
+            for (; unionRange < unionRanges.size() && unionRanges[unionRange].first < chunkEnd; ++unionRange)
+            {
+                const BinRange& range = unionRanges[unionRange];
+                const int from = std::max(range.first, chunkFirst);
+                const int to = std::min(range.end, chunkEnd);
+                for (int i = from; i < to; ++i)
+                {
+                    bandEnergy += spectrum[i] * spectrum[i];
+                }
+
+                // A range running on into the next chunk is picked up again there
+                if (range.end > chunkEnd)
+                {
+                    break;
+                }
+            }
+
+            for (size_t band = 0; band < bandRanges.size(); ++band)
+            {
+                const int from = std::max(bandRanges[band].first, chunkFirst);
+                const int to = std::min(bandRanges[band].end, chunkEnd);
+                for (int i = from; i < to; ++i)
+                {
+                    features.bandEnergies[band] += spectrum[i] * spectrum[i];
+                }
+            }
+
+            for (int row = chunkRowStart[chunk]; row < chunkRowStart[chunk + 1]; ++row)
+            {
+                const int bucket = chunkRows[row];
+                features.buckets[bucket] += dotProduct(filterbank->getRowWeights(bucket), spectrum + filterbank->getRowFirstBin(bucket), filterbank->getRowSize(bucket));
+            }
+        }
+    }
+
+    const int channels = std::max(lastChannel - firstChannel, 0);
+    const float binWidth = (config.sampleRate / 2) / bins;
+
+    features.energy = energy;
+    features.bandEnergy = bandEnergy;
+    features.centroid = energy > 0.0f ? binWidth * weightedBins / energy : 0.0f;
+    features.flatness = energy > 0.0f && channels > 0 ? std::exp2(logSum / float(bins * channels)) / (energy / float(bins * channels)) : 0.0f;
+    features.rolloff = 0.0f;
+
+    // Only the chunk the rolloff falls into is walked again, bin by bin
+    const float target = config.rolloffFraction * energy;
+    float below{ 0.0f };
+    for (int chunk = 0; chunk < chunks && energy > 0.0f; ++chunk)
+    {
+        if (below + chunkPower[chunk] < target && chunk + 1 < chunks)
+        {
+            below += chunkPower[chunk];
+            continue;
+        }
+
+        const int chunkEnd = std::min((chunk + 1) * CHUNK_BINS, bins);
+        int bin = chunk * CHUNK_BINS;
+        for (; bin < chunkEnd - 1; ++bin)
+        {
+            for (int c = firstChannel; c < lastChannel; ++c)
+            {
+                below += frame.channel(c)[bin] * frame.channel(c)[bin];
+            }
+            if (below >= target)
+            {
+                break;
+            }
+        }
+        features.rolloff = binWidth * bin;
+        break;
+    }
+
+    return true;
+}
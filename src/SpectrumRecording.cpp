@@ -0,0 +1,93 @@
+#include "SpectrumRecording.h"
+
+#include "BinaryIO.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+constexpr char MAGIC[4] = { 'B', 'S', 'R', '1' };
+
+// Sanity limits for headers read back from a file
+constexpr int32_t MAX_CHANNELS = 64;
+constexpr int32_t MAX_LENGTH = 1 << 20;
+}  // namespace
+
+bool SpectrumRecorder::open(const std::filesystem::path& path, const int sampleRateArg)
+{
+    file.open(path, std::ios::binary);
+    if (!file)
+    {
+        std::cout << "ERROR::SPECTRUM_RECORDER::CANNOT_WRITE " << path << "\n";
+        return false;
+    }
+
+    file.write(MAGIC, sizeof(MAGIC));
+    writeValue(file, int32_t(sampleRateArg));
+    return true;
+}
+
+void SpectrumRecorder::write(const int resolution, const SpectrumFrame& frame)
+{
+    writeValue(file, int32_t(resolution));
+    writeValue(file, int32_t(frame.numChannels));
+    writeValue(file, int32_t(frame.length));
+    writeValue(file, uint64_t(frame.samplePosition));
+    file.write(reinterpret_cast<const char*>(frame.data.data()), std::streamsize(sizeof(float) * frame.data.size()));
+}
+
+bool SpectrumReplay::open(const std::filesystem::path& path)
+{
+    file.open(path, std::ios::binary);
+
+    char magic[sizeof(MAGIC)];
+    int32_t rate = 0;
+    if (!file || !file.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), MAGIC) || !readValue(file, rate) || rate <= 0)
+    {
+        std::cout << "ERROR::SPECTRUM_REPLAY::BAD_FILE " << path << "\n";
+        return false;
+    }
+
+    sampleRate = rate;
+    pending = readHeader();
+    startPosition = nextPosition;
+    return true;
+}
+
+bool SpectrumReplay::next(int& resolution, SpectrumFrame& frame, const uint64_t until)
+{
+    if (!pending || nextPosition > until)
+    {
+        return false;
+    }
+
+    resolution = nextResolution;
+    frame.resize(nextChannels, nextLength);
+    frame.samplePosition = nextPosition;
+    if (!file.read(reinterpret_cast<char*>(frame.data.data()), std::streamsize(sizeof(float) * frame.data.size())))
+    {
+        std::cout << "ERROR::SPECTRUM_REPLAY::TRUNCATED\n";
+        pending = false;
+        return false;
+    }
+
+    pending = readHeader();
+    return true;
+}
+
+bool SpectrumReplay::readHeader()
+{
+    if (!readValue(file, nextResolution) || !readValue(file, nextChannels) || !readValue(file, nextLength) || !readValue(file, nextPosition))
+    {
+        return false;
+    }
+
+    if (nextChannels < 0 || nextChannels > MAX_CHANNELS || nextLength < 0 || nextLength > MAX_LENGTH)
+    {
+        std::cout << "ERROR::SPECTRUM_REPLAY::BAD_FRAME\n";
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,69 @@
+#include "SpectrumRenderer.h"
+
+#include <algorithm>
+
+SpectrumRenderer::SpectrumRenderer(Shader& shaderArg, const int bucketsArg, const float yPos, const float maxHeightArg)
+    : buckets(bucketsArg)
+    , yCoordBottom(yPos)
+    , maxHeight(maxHeightArg)
+    , shader(shaderArg)
+    , heightBuffer(GL_TEXTURE_BUFFER, 2 * bucketsArg * sizeof(float), sizeof(float))
+{
+    heightsUniform = shader.getUniform<int>("heights");
+    firstHeightUniform = shader.getUniform<int>("firstHeight");
+    bucketsUniform = shader.getUniform<int>("buckets");
+    baseYUniform = shader.getUniform<float>("baseY");
+    maxHeightUniform = shader.getUniform<float>("maxHeight");
+    redThresholdUniform = shader.getUniform<float>("redThreshold");
+
+    // The texture spans every region of the ring, the shader is told where the current frame starts
+    glGenTextures(1, &heightTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, heightTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32F, heightBuffer.getID());
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    // No vertex attributes at all, the core profile still needs a bound VAO
+    glGenVertexArrays(1, &VAO);
+}
+
+SpectrumRenderer::~SpectrumRenderer()
+{
+    glDeleteTextures(1, &heightTexture);
+    glDeleteVertexArrays(1, &VAO);
+}
+
+void SpectrumRenderer::update(const std::vector<float>& heights, const std::vector<float>& peaks)
+{
+    drawPeaks = !peaks.empty();
+
+    // Heights first, peaks right after them, the shader indexes both with gl_InstanceID
+    float* dst = static_cast<float*>(heightBuffer.beginWrite());
+    if (dst)
+    {
+        std::copy(heights.begin(), heights.begin() + std::min(int(heights.size()), buckets), dst);
+        std::copy(peaks.begin(), peaks.begin() + std::min(int(peaks.size()), buckets), dst + buckets);
+    }
+    heightOffset = heightBuffer.endWrite();
+}
+
+void SpectrumRenderer::draw()
+{
+    shader.use();
+    shader.set(heightsUniform, 0);
+    shader.set(firstHeightUniform, int(heightOffset / GLintptr(sizeof(float))));
+    shader.set(bucketsUniform, buckets);
+    shader.set(baseYUniform, yCoordBottom);
+    shader.set(maxHeightUniform, maxHeight);
+    shader.set(redThresholdUniform, 0.5f);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_BUFFER, heightTexture);
+
+    glBindVertexArray(VAO);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, drawPeaks ? 2 * buckets : buckets);
+    glBindVertexArray(0);
+
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    heightBuffer.fence();
+}
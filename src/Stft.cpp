@@ -0,0 +1,116 @@
+#include "Stft.h"
+
+#include "PcmRingBuffer.h"
+
+#include <cmath>
+#include <mutex>
+#include <numeric>
+
+namespace
+{
+constexpr double PI = 3.14159265358979323846;
+
+// Only fftw_execute is thread safe, planning is not
+std::mutex planMutex;
+
+void applyWindow(double* out, const float* samples, const float* window, const int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        out[i] = double(samples[i]) * double(window[i]);
+    }
+}
+}  // namespace
+
+Stft::Stft(const StftConfig& configArg)
+    : config(configArg)
+    , window(makeWindow(configArg.window, configArg.windowSize))
+{
+    // Coherent gain of the window, so the scale does not depend on the window function
+    magnitudeScale = 2.0f / std::accumulate(window.begin(), window.end(), 0.0f);
+
+    const int bins = config.windowSize / 2 + 1;
+
+    const std::lock_guard<std::mutex> lock(planMutex);
+    input = static_cast<double*>(fftw_malloc(sizeof(double) * config.windowSize));
+    output = static_cast<fftw_complex*>(fftw_malloc(sizeof(fftw_complex) * bins));
+    plan = fftw_plan_dft_r2c_1d(config.windowSize, input, output, FFTW_MEASURE);
+}
+
+Stft::~Stft()
+{
+    const std::lock_guard<std::mutex> lock(planMutex);
+    fftw_destroy_plan(plan);
+    fftw_free(output);
+    fftw_free(input);
+}
+
+std::vector<float> Stft::makeWindow(const WindowFunction function, const int size)
+{
+    std::vector<float> ret(size);
+
+    // Periodic windows, they add up evenly at the usual hops
+    for (int i = 0; i < size; ++i)
+    {
+        const double phase = 2.0 * PI * i / size;
+        switch (function)
+        {
+            case WindowFunction::Hann:
+                ret[i] = float(0.5 - 0.5 * std::cos(phase));
+                break;
+            case WindowFunction::BlackmanHarris:
+                ret[i] = float(0.35875 - 0.48829 * std::cos(phase) + 0.14128 * std::cos(2.0 * phase) - 0.01168 * std::cos(3.0 * phase));
+                break;
+        }
+    }
+
+    return ret;
+}
+
+uint64_t Stft::getNextStart(const PcmRingBuffer& ring) const
+{
+    if (position >= ring.getOldestPosition())
+    {
+        return position;
+    }
+
+    // Fell behind the writer, continue from the oldest frame that is still complete
+    const uint64_t behind = ring.getOldestPosition() - position;
+    return position + ((behind + config.hop - 1) / config.hop) * config.hop;
+}
+
+bool Stft::isReady(const PcmRingBuffer& ring) const
+{
+    return getNextStart(ring) + uint64_t(config.windowSize) <= ring.getWritePosition();
+}
+
+bool Stft::next(const PcmRingBuffer& ring, SpectrumFrame& frame)
+{
+    if (!isReady(ring))
+    {
+        return false;
+    }
+    position = getNextStart(ring);
+
+    frame.resize(ring.getChannels(), config.windowSize);
+
+    const int bins = frame.bins();
+    for (int c = 0; c < ring.getChannels(); ++c)
+    {
+        const PcmRingBuffer::Segments segments = ring.read(c, position, config.windowSize);
+        applyWindow(input, segments.first, window.data(), segments.firstCount);
+        applyWindow(input + segments.firstCount, segments.second, window.data() + segments.firstCount, segments.secondCount);
+
+        fftw_execute(plan);
+
+        float* out = frame.channel(c);
+        for (int i = 0; i < bins; ++i)
+        {
+            out[i] = float(std::hypot(output[i][0], output[i][1])) * magnitudeScale;
+        }
+    }
+
+    frame.samplePosition = position + uint64_t(config.windowSize / 2);
+    position += config.hop;
+    return true;
+}
@@ -0,0 +1,102 @@
+#include "StreamingBuffer.h"
+
+#include <iostream>
+
+StreamingBuffer::StreamingBuffer(const GLenum targetArg, const GLsizeiptr regionSizeArg, const GLsizeiptr alignment)
+    : target(targetArg)
+    , regionSize(regionSizeArg)
+    , regionStride(((regionSizeArg + alignment - 1) / alignment) * alignment)
+{
+    const GLsizeiptr totalSize = regionStride * REGIONS;
+
+    glGenBuffers(1, &ID);
+    glBindBuffer(target, ID);
+
+    if (GLAD_GL_VERSION_4_4)
+    {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(target, totalSize, nullptr, flags);
+        persistentPtr = glMapBufferRange(target, 0, totalSize, flags);
+
+        if (!persistentPtr)
+        {
+            std::cout << "ERROR::STREAMING_BUFFER::PERSISTENT_MAPPING_FAILED\n";
+        }
+    }
+    else
+    {
+        glBufferData(target, totalSize, nullptr, GL_STREAM_DRAW);
+    }
+
+    glBindBuffer(target, 0);
+}
+
+StreamingBuffer::~StreamingBuffer()
+{
+    for (GLsync& sync : fences)
+    {
+        if (sync)
+        {
+            glDeleteSync(sync);
+            sync = nullptr;
+        }
+    }
+
+    if (persistentPtr)
+    {
+        glBindBuffer(target, ID);
+        glUnmapBuffer(target);
+        glBindBuffer(target, 0);
+    }
+
+    glDeleteBuffers(1, &ID);
+}
+
+void* StreamingBuffer::beginWrite()
+{
+    region = (region + 1) % REGIONS;
+
+    GLsync& sync = fences[region];
+    if (sync)
+    {
+        GLenum waitResult = glClientWaitSync(sync, 0, 0);
+        while (waitResult == GL_TIMEOUT_EXPIRED)
+        {
+            waitResult = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);  // 1 ms
+        }
+
+        glDeleteSync(sync);
+        sync = nullptr;
+    }
+
+    if (persistentPtr)
+    {
+        return static_cast<char*>(persistentPtr) + getOffset();
+    }
+
+    // The fence already guarantees the GPU is done with this region, no need for the driver to synchronize again
+    glBindBuffer(target, ID);
+    return glMapBufferRange(target, getOffset(), regionSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+}
+
+GLintptr StreamingBuffer::endWrite()
+{
+    if (!persistentPtr)
+    {
+        glBindBuffer(target, ID);
+        glUnmapBuffer(target);
+        glBindBuffer(target, 0);
+    }
+
+    return getOffset();
+}
+
+void StreamingBuffer::fence()
+{
+    if (fences[region])
+    {
+        glDeleteSync(fences[region]);
+    }
+
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
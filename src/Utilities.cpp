@@ -22,4 +22,11 @@ std::filesystem::path getSoundsFolderPath()
 std::filesystem::path getSoundPath(const std::string& soundName)
 {
     return std::filesystem::path(getSoundsFolderPath().string() + soundName);
-}
\ No newline at end of file
+}
+
+std::filesystem::path getCacheFolderPath()
+{
+    std::string root = std::filesystem::current_path().parent_path().string();
+    root.append("/cache/");
+    return std::filesystem::path(root);
+}
@@ -0,0 +1,69 @@
+#include "WaterfallView.h"
+
+#include <algorithm>
+
+WaterfallView::WaterfallView(Shader& shaderArg, const int bucketsArg, const int historyRowsArg, const float xPos, const float yPos, const float widthArg, const float heightArg)
+    : buckets(bucketsArg)
+    , historyRows(historyRowsArg)
+    , xCoordBottomLeft(xPos)
+    , yCoordBottomLeft(yPos)
+    , width(widthArg)
+    , height(heightArg)
+    , shader(shaderArg)
+{
+    originUniform = shader.getUniform<glm::vec2>("origin");
+    sizeUniform = shader.getUniform<glm::vec2>("size");
+    historyUniform = shader.getUniform<int>("history");
+    rowOffsetUniform = shader.getUniform<float>("rowOffset");
+
+    const std::vector<float> empty(size_t(buckets) * size_t(historyRows), 0.0f);
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, buckets, historyRows, 0, GL_RED, GL_FLOAT, &empty[0]);
+
+    // Nearest filtering keeps the newest and the oldest row from bleeding into each other at the seam
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // The quad is generated from gl_VertexID, the core profile still needs a bound VAO
+    glGenVertexArrays(1, &VAO);
+}
+
+WaterfallView::~WaterfallView()
+{
+    glDeleteTextures(1, &texture);
+    glDeleteVertexArrays(1, &VAO);
+}
+
+void WaterfallView::update(const std::vector<float>& values)
+{
+    newestRow = (newestRow + 1) % historyRows;
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, newestRow, std::min(int(values.size()), buckets), 1, GL_RED, GL_FLOAT, &values[0]);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void WaterfallView::draw()
+{
+    shader.use();
+    shader.set(originUniform, glm::vec2(xCoordBottomLeft, yCoordBottomLeft));
+    shader.set(sizeUniform, glm::vec2(width, height));
+    shader.set(historyUniform, 0);
+
+    // The row after the newest one is the oldest, that one goes to the bottom
+    shader.set(rowOffsetUniform, float(newestRow + 1) / historyRows);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    glBindVertexArray(VAO);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
@@ -1,6 +1,31 @@
 #include "Utilities.h"
 #include "SpectrogramBar.h"
+#include "ShaderManager.h"
+#include "SpectrumRenderer.h"
+#include "WaterfallView.h"
 #include "KeyPressWatcher.h"
+#include "ChannelMixer.h"
+#include "SpectrumAnalysis.h"
+#include "Filterbank.h"
+#include "PcmTap.h"
+#include "MultiResolutionStft.h"
+#include "AudioClock.h"
+#include "BeatDetector.h"
+#include "HitJudge.h"
+#include "FileAudioSource.h"
+#include "OfflineAnalyser.h"
+#include "JudgeEngine.h"
+#include "ParameterSweep.h"
+#include "Evaluation.h"
+#include "SignalGenerator.h"
+#include "SpectrumRecording.h"
+#include "OffscreenTarget.h"
+#include "Options.h"
+#include "FramePacer.h"
+#include "FrameInterpolator.h"
+#include "BarSmoother.h"
+#include "Normaliser.h"
+#include "MagnitudeScale.h"
 
 #include "fmod.hpp"
 #include "fmod_studio.hpp"
@@ -9,18 +34,31 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <algorithm>
 #include <iostream>
 #include <filesystem>
+#include <fstream>
+#include <limits>
 #include <chrono>
-#include <numeric>
+#include <memory>
+#include <vector>
 
 // Configs
 constexpr int FFT_WINDOWS = 8192;
+constexpr int DISPLAY_HOP = 512;
+constexpr int ONSET_WINDOW = 1024;
+constexpr int ONSET_HOP = 441;  // 10 ms at 44.1 kHz
 constexpr uint32_t WINDOW_WIDTH = 1024;
 constexpr uint32_t WINDOW_HEIGHT = 768;
 constexpr int BUCKETS = 64;
-constexpr bool LOGARITHMIC = true;
-constexpr int SOUND_FRAME_MEMORY = 60;
+constexpr FilterbankScale SCALE = FilterbankScale::Log;
+constexpr bool PERCEPTUAL_MAGNITUDES = true;  // A-weighted dB instead of linear magnitude sums
+constexpr bool WATERFALL = false;
+constexpr int WATERFALL_HISTORY = 1024;  // rows, ~17 seconds at 60 FPS
+constexpr int SOUND_FRAME_MEMORY = 100;  // onset hops, ~1 second
+constexpr ChannelLayout CHANNEL_LAYOUT = ChannelLayout::Mono;
+constexpr float TARGET_FPS = 144.0f;  // 0 leaves the pacing to vsync
+constexpr VsyncMode VSYNC = VsyncMode::Adaptive;
 
 KeyPressWatcher watch(GLFW_KEY_ENTER);
 
@@ -35,8 +73,6 @@ void processInput(GLFWwindow* window)
     {
         glfwSetWindowShouldClose(window, true);
     }
-
-    watch.update(window);
 }
 
 bool fmodErrorCheck(const FMOD_RESULT result)
@@ -50,166 +86,86 @@ bool fmodErrorCheck(const FMOD_RESULT result)
     return true;
 }
 
-void printSpectrum(FMOD_DSP_PARAMETER_FFT* data)
+// Generated sounds are FMOD user streams, the generator is the sound's user data
+SignalGenerator* getGenerator(FMOD_SOUND* sound)
 {
-    if (data->length > 0)
-    {
-        for (int i = 0; i < data->numchannels; ++i)
-        {
-            for (int j = 0; j < data->length; ++j)
-            {
-                std::cout << data->spectrum[i][j] << " ";
-            }
-            std::cout << "\n";
-        }
-    }
+    void* userData = nullptr;
+    reinterpret_cast<FMOD::Sound*>(sound)->getUserData(&userData);
+    return static_cast<SignalGenerator*>(userData);
 }
 
-void fillCountsLinear(std::vector<float>& counts, FMOD_DSP_PARAMETER_FFT* fftData)
+FMOD_RESULT F_CALLBACK readGenerator(FMOD_SOUND* sound, void* data, unsigned int datalen)
 {
-    const int bucketsize = ((fftData->length / 2) / BUCKETS) + 1;  // round up
-
-    for (int channel = 0; channel < fftData->numchannels; ++channel)
-    {
-        for (int i = 0; i < fftData->length / 2; ++i)
-        {
-            const int currentBucket = i / bucketsize;
-            const float val = fftData->spectrum[channel][i];
-
-            counts[currentBucket] += val;
-        }
-    }
+    float* out = static_cast<float*>(data);
+    SignalGenerator* generator = getGenerator(sound);
+    const int channels = generator ? generator->getChannels() : 1;
+    const int frames = int(datalen / (channels * sizeof(float)));
 
-    const float max = *std::max_element(counts.begin(), counts.end());
+    const int read = generator ? generator->read(out, frames) : 0;
+    std::fill(out + read * channels, out + frames * channels, 0.0f);
 
-    for (int i = 0; i < counts.size(); ++i)
-    {
-        counts[i] /= max;
-    }
+    return FMOD_OK;
 }
 
-void fillCountsLog(std::vector<float>& counts, FMOD_DSP_PARAMETER_FFT* fftData)
+FMOD_RESULT F_CALLBACK seekGenerator(FMOD_SOUND* sound, const int /*subsound*/, const unsigned int position, const FMOD_TIMEUNIT postype)
 {
-    std::vector<float> limits;
-    limits.resize(BUCKETS);
-
-    const float mult = BUCKETS / 12.0f;  // magic
-
-    for (int i = 0; i < BUCKETS; ++i)
-    {
-        const float curr = (44100.0f / 2) * pow(0.5f + 0.41f * (1 - exp(-1 * (mult - 1))), i + 1);  // magic
-        limits[i] = curr;
-        //std::cout << curr << "\n";
-    }
-
-    std::reverse(limits.begin(), limits.end());
-
-    for (int channel = 0; channel < fftData->numchannels; ++channel)
+    SignalGenerator* generator = getGenerator(sound);
+    if (generator && postype == FMOD_TIMEUNIT_PCM)
     {
-        for (int i = 0; i < fftData->length / 2; ++i)
-        {
-            const float currentFreq = (44100.0f / 2) * (float(i) / (fftData->length / 2));
-
-            //if (currentFreq > 500)
-            //{
-            //	continue;
-            //}
-
-            if (currentFreq > limits[limits.size() - 1])
-            {
-                counts[counts.size() - 1] += fftData->spectrum[channel][i];
-            }
-            else
-            {
-                const int currentBucket = -1;
-                for (size_t j = 0; j < limits.size() - 1; ++j)
-                {
-                    if (currentFreq < limits[j + size_t(1)])
-                    {
-                        counts[j] += fftData->spectrum[channel][i];
-                        break;
-                    }
-                }
-            }
-        }
+        generator->seek(position);
     }
 
-    const float max = *std::max_element(counts.begin(), counts.end());
-
-    for (int i = 0; i < counts.size(); ++i)
-    {
-        counts[i] /= max;
-    }
+    return FMOD_OK;
 }
 
-float calculateSoundEnergy(FMOD_DSP_PARAMETER_FFT* fftData)
+OfflineAnalysisConfig makeAnalysisConfig()
 {
-    float ret{ 0.0f };
-
-    for (int channel = 0; channel < fftData->numchannels; ++channel)
-    {
-        for (int i = 0; i < fftData->length / 2; ++i)
-        {
-            ret += fftData->spectrum[channel][i] * fftData->spectrum[channel][i];
-        }
-    }
-
+    OfflineAnalysisConfig ret;
+    ret.layout = CHANNEL_LAYOUT;
+    ret.stft = { ONSET_WINDOW, ONSET_HOP };
+    ret.detector.history = SOUND_FRAME_MEMORY;
     return ret;
 }
 
-float calculateSoundEnergyInBands(FMOD_DSP_PARAMETER_FFT* fftData, const std::vector<std::pair<float, float>>& bands)
+void printSpectrum(FMOD_DSP_PARAMETER_FFT* data)
 {
-    float ret{ 0.0f };
-
-    for (int channel = 0; channel < fftData->numchannels; ++channel)
+    if (data->length > 0)
     {
-        for (int i = 0; i < fftData->length / 2; ++i)
+        for (int i = 0; i < data->numchannels; ++i)
         {
-            const float currentFreq = (44100.0f / 2) * (float(i) / (fftData->length / 2));
-
-            bool foundInBand = false;
-            for (int band = 0; band < bands.size(); ++band)
-            {
-                if (currentFreq >= bands[band].first && currentFreq <= bands[band].second)
-                {
-                    foundInBand = true;
-                    break;
-                }
-            }
-
-            if (!foundInBand)
+            for (int j = 0; j < data->length; ++j)
             {
-                continue;
+                std::cout << data->spectrum[i][j] << " ";
             }
-
-            ret += fftData->spectrum[channel][i] * fftData->spectrum[channel][i];
+            std::cout << "\n";
         }
     }
-
-    return ret;
 }
 
-float calculateEnergyVariance(const std::vector<float>& energies, const float average)
+int main(int argc, char* argv[])
 {
-    float ret{ 0.0f };
-
-    for (int i = 0; i < energies.size(); ++i)
+    const std::optional<Options> parsedOptions = parseOptions(argc, argv);
+    if (!parsedOptions)
     {
-        ret += (energies[i] - average) * (energies[i] - average);
+        return -1;
     }
+    const Options& options = *parsedOptions;
 
-    ret *= 1 / float(energies.size());
-
-    return ret;
-}
+    if (!options.sweepFolder.empty())
+    {
+        return runSweepTool(options.sweepFolder, options.featureCache, makeAnalysisConfig());
+    }
+    if (!options.evaluationFolder.empty())
+    {
+        return runEvaluationTool(options.evaluationFolder, makeAnalysisConfig());
+    }
 
-int main()
-{
     // Initialize GLFW and GLAD
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, options.offscreen ? GLFW_FALSE : GLFW_TRUE);
 
     GLFWwindow* window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Spectrum", nullptr, nullptr);
     if (window == nullptr)
@@ -228,6 +184,12 @@ int main()
     }
 
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    watch.install(window);
+
+    // Offscreen frames are paced by the fixed time step alone
+    FramePacer pacer(options.offscreen ? 0.0f : TARGET_FPS, options.offscreen ? VsyncMode::Off : VSYNC);
+    pacer.setPumpEvents(!options.offscreen);
+    pacer.apply();
 
     FMOD_RESULT result;
     FMOD::Studio::System* studioSystem = nullptr;
@@ -238,6 +200,19 @@ int main()
         return -1;
     }
 
+    FMOD::System* lowLevel;
+    studioSystem->getCoreSystem(&lowLevel);
+
+    if (options.offscreen)
+    {
+        // The mixer only advances on update, so the song is rendered as fast as we can render frames
+        result = lowLevel->setOutput(FMOD_OUTPUTTYPE_NOSOUND_NRT);
+        if (!fmodErrorCheck(result))
+        {
+            return -1;
+        }
+    }
+
     result = studioSystem->initialize(512, FMOD_STUDIO_INIT_NORMAL, FMOD_INIT_NORMAL, nullptr);
     if (!fmodErrorCheck(result))
     {
@@ -245,140 +220,492 @@ int main()
         return -1;
     }
 
-    FMOD::System* lowLevel;
-    studioSystem->getCoreSystem(&lowLevel);
-
-    const FMOD_MODE mode = FMOD_DEFAULT | FMOD_2D | FMOD_LOOP_NORMAL | FMOD_CREATESTREAM;
+    // A chart covers the song once, so it is not looped in chart mode
+    const FMOD_MODE mode = FMOD_DEFAULT | FMOD_2D | (options.chart ? FMOD_LOOP_OFF : FMOD_LOOP_NORMAL) | FMOD_CREATESTREAM;
 
     FMOD::Sound* testSound;
-    const std::string soundStr = getSoundPath("test2.mp3").string();
+    const std::string soundStr = getSoundPath(options.sound).string();
 
-    result = lowLevel->createSound(soundStr.c_str(), mode, nullptr, &testSound);
-    if (!fmodErrorCheck(result))
+    std::optional<SignalGeneratorConfig> signalConfig;
+    std::unique_ptr<SignalGenerator> generator;
+    if (!options.signal.empty())
     {
-        std::cout << soundStr << "\n";
-        system("pause");
-        return -1;
+        signalConfig = SignalGenerator::preset(options.signal, options.signalBpm, options.signalSeconds);
+        if (!signalConfig)
+        {
+            std::cout << "Unknown signal " << options.signal << "\n";
+            return -1;
+        }
+        generator = std::make_unique<SignalGenerator>(*signalConfig);
+
+        // FMOD takes the length of a user sound in bytes as an unsigned int
+        const uint64_t frameBytes = uint64_t(generator->getChannels()) * sizeof(float);
+        if (generator->getLength() > std::numeric_limits<unsigned int>::max() / frameBytes)
+        {
+            std::cout << "ERROR::SIGNAL::TOO_LONG " << options.signalSeconds << " s, at most "
+                      << std::numeric_limits<unsigned int>::max() / frameBytes / generator->getSampleRate() << " s\n";
+            return -1;
+        }
     }
 
-    FMOD::Channel* testChannel;
-    result = lowLevel->playSound(testSound, nullptr, false, &testChannel);
-    if (!fmodErrorCheck(result))
+    std::unique_ptr<JudgeEngine> judgeEngine;
+    Chart chart;
+    if (options.chart)
     {
-        system("pause");
-        return -1;
+        const auto analysisStart = std::chrono::steady_clock::now();
+        chart = OfflineAnalyser(makeAnalysisConfig()).analyseParallel([&]() {
+            if (signalConfig)
+            {
+                return std::unique_ptr<AudioSource>(std::make_unique<SignalGenerator>(*signalConfig));
+            }
+
+            auto source = std::make_unique<FileAudioSource>(lowLevel, soundStr);
+            return source->isOpen() ? std::unique_ptr<AudioSource>(std::move(source)) : nullptr;
+        });
+        if (chart.sampleRate == 0)
+        {
+            system("pause");
+            return -1;
+        }
+
+        const auto analysisTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - analysisStart);
+
+        std::cout << "Chart: " << chart.beats.size() << " beats in " << chart.length / double(chart.sampleRate) << " s, analysed in " << analysisTime.count()
+                  << " ms\n";
+        judgeEngine = std::make_unique<JudgeEngine>(chart);
     }
 
-    FMOD::DSP* testDSP;
-    result = lowLevel->createDSPByType(FMOD_DSP_TYPE_FFT, &testDSP);
-    if (!fmodErrorCheck(result))
+    // A replay brings its own frames, nothing is played then
+    std::unique_ptr<SpectrumReplay> replay;
+    if (!options.replayPath.empty())
     {
-        system("pause");
-        return -1;
+        replay = std::make_unique<SpectrumReplay>();
+        if (!replay->open(options.replayPath))
+        {
+            return -1;
+        }
     }
-    testDSP->setParameterInt(FMOD_DSP_FFT_WINDOWSIZE, FFT_WINDOWS);
 
-    result = testChannel->addDSP(1, testDSP);
-    if (!fmodErrorCheck(result))
+    FMOD::Channel* testChannel = nullptr;
+    PcmTap tap;
+    if (!replay)
+    {
+        if (generator)
+        {
+            FMOD_CREATESOUNDEXINFO info{};
+            info.cbsize = sizeof(info);
+            info.numchannels = generator->getChannels();
+            info.defaultfrequency = generator->getSampleRate();
+            info.format = FMOD_SOUND_FORMAT_PCMFLOAT;
+            info.length = unsigned(generator->getLength() * generator->getChannels() * sizeof(float));  // checked to fit above
+            info.decodebuffersize = 4096;
+            info.pcmreadcallback = readGenerator;
+            info.pcmsetposcallback = seekGenerator;
+            info.userdata = generator.get();
+            result = lowLevel->createSound(nullptr, mode | FMOD_OPENUSER, &info, &testSound);
+        }
+        else
+        {
+            result = lowLevel->createSound(soundStr.c_str(), mode, nullptr, &testSound);
+        }
+        if (!fmodErrorCheck(result))
+        {
+            std::cout << (generator ? options.signal : soundStr) << "\n";
+            system("pause");
+            return -1;
+        }
+
+        result = lowLevel->playSound(testSound, nullptr, false, &testChannel);
+        if (!fmodErrorCheck(result))
+        {
+            system("pause");
+            return -1;
+        }
+
+        result = tap.attach(lowLevel, testChannel, 1);
+        if (!fmodErrorCheck(result))
+        {
+            system("pause");
+            return -1;
+        }
+    }
+
+    int sampleRate = 0;
+    lowLevel->getSoftwareFormat(&sampleRate, nullptr, nullptr);
+    if (replay)
+    {
+        sampleRate = replay->getSampleRate();
+    }
+
+    SpectrumRecorder recorder;
+    if (!options.recordPath.empty() && !recorder.open(options.recordPath, sampleRate))
     {
-        system("pause");
         return -1;
     }
 
 
-    std::vector<SpectrogramBar> bars;
+    Shader::setBinaryCacheFolder(getCacheFolderPath());
+    ShaderManager shaders(getShaderFolderPath());
+    SpectrogramBar::setShader(shaders.get("bar.vs", "bar.fs"));
+
+    auto spectrum = std::make_unique<SpectrumRenderer>(shaders.get("spectrum.vs", "spectrum.fs"), BUCKETS, 0.1f, 0.6f);
+    auto waterfall = std::make_unique<WaterfallView>(shaders.get("waterfall.vs", "waterfall.fs"), BUCKETS, WATERFALL_HISTORY, 0.0f, 0.1f, 1.0f, 0.75f);
+
+    std::unique_ptr<OffscreenTarget> offscreen;
+    std::ofstream framesFile;
+    std::vector<unsigned char> pixels;
+    int renderedFrames = 0;
+    double offscreenClock = 0.0;
+    double samplesPerFrame = 0.0;
+
+    if (options.offscreen)
+    {
+        offscreen = std::make_unique<OffscreenTarget>(WINDOW_WIDTH, WINDOW_HEIGHT);
+
+        if (!options.framesOutput.empty())
+        {
+            framesFile.open(options.framesOutput, std::ios::binary);
+            if (!framesFile)
+            {
+                std::cout << "ERROR::OFFSCREEN::CANNOT_WRITE_FRAMES " << options.framesOutput << "\n";
+                return -1;
+            }
+        }
+
+        samplesPerFrame = sampleRate / double(options.offscreenFps);
+
+        unsigned long long startClock = replay ? replay->getStartPosition() : 0;
+        if (testChannel)
+        {
+            testChannel->getDSPClock(&startClock, nullptr);
+        }
+        offscreenClock = double(startClock);
+    }
+
+    const auto writeFrames = [&](const bool wait) {
+        while (offscreen->collect(pixels, wait || offscreen->pendingFrames() == OffscreenTarget::PBOS))
+        {
+            if (framesFile.is_open())
+            {
+                framesFile.write(reinterpret_cast<const char*>(pixels.data()), std::streamsize(pixels.size()));
+            }
+        }
+    };
 
     std::chrono::steady_clock::time_point earlier = std::chrono::steady_clock::now();
 
-    std::vector<float> memory;
-    memory.resize(SOUND_FRAME_MEMORY);
-    uint32_t memoryPtr = 0;
+    const ChannelMixer mixer(CHANNEL_LAYOUT);
+    std::vector<float> mixedPcm;
+    SpectrumFrame frame;
+
+    // Created with the first block, that is when the channel count is known
+    enum Resolution
+    {
+        DISPLAY_RESOLUTION,
+        ONSET_RESOLUTION,
+    };
+    std::unique_ptr<MultiResolutionStft> stft;
+    uint64_t playbackStart = 0;
+
+    // Mixer clock to the chart's samples, the chart starts with the first block the tap saw
+    const auto toChartPosition = [&](const uint64_t mixerPosition) {
+        const double seconds = mixerPosition > playbackStart ? double(mixerPosition - playbackStart) / sampleRate : 0.0;
+        return uint64_t(seconds * chart.sampleRate);
+    };
+
+    AudioClock audioClock(sampleRate);
+
+    // What is heard now was mixed this many samples ago, presses are judged against what was heard
+    unsigned int dspBufferLength = 0;
+    int dspBufferCount = 0;
+    lowLevel->getDSPBufferSize(&dspBufferLength, &dspBufferCount);
+    const uint64_t outputLatency = uint64_t(dspBufferLength) * uint64_t(dspBufferCount);
+
+    HitJudge hitJudge(sampleRate);
+    std::vector<JudgedPress> judgedPresses;
+    uint64_t analysedPosition = 0;
+    BeatDetectorConfig detectorConfig;
+    detectorConfig.history = SOUND_FRAME_MEMORY;
+    BeatDetector detector(detectorConfig);
+
+    // Analysis runs once per freshly mixed DSP block, rendering runs at the pacer's rate in between
+    FrameInterpolator interpolator(BUCKETS);
+    BarSmoother smoother(BUCKETS);
+    Normaliser normaliser;
+    const Filterbank filterbank({ SCALE, BUCKETS, FFT_WINDOWS / 2 });
+    const MagnitudeScale magnitudeScale(filterbank.getCentreFrequencies());
+    std::vector<float> displayCounts;
+    bool beatDetected = false;
+    bool hitDetected = false;
+
+    const auto offscreenStart = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point previousFrameTime = offscreenStart;
 
     glEnable(GL_DEPTH_TEST);
-    while (!glfwWindowShouldClose(window))
+    while (!glfwWindowShouldClose(window) && (!options.offscreen || renderedFrames < options.offscreenFrames))
     {
-        result = studioSystem->update();
-        if (!fmodErrorCheck(result))
+        std::chrono::steady_clock::time_point frameTime;
+        if (options.offscreen)
         {
-            system("pause");
-            return -1;
+            frameTime = offscreenStart
+                + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(renderedFrames / double(options.offscreenFps)));
+        }
+        else
+        {
+            frameTime = pacer.waitForNextFrame();
         }
 
-        FMOD_DSP_PARAMETER_FFT* data = nullptr;
-        result = testDSP->getParameterData(FMOD_DSP_FFT_SPECTRUMDATA, (void**)(&data), nullptr, nullptr, 0);
+        result = studioSystem->update();
         if (!fmodErrorCheck(result))
         {
             system("pause");
             return -1;
         }
 
-        std::vector<float> counts;
-        counts.resize(BUCKETS);
+        if (options.offscreen)
+        {
+            // Fixed time step, mix until the audio is one frame further
+            offscreenClock += samplesPerFrame;
+        }
+        // A channel that played to its end is released and has no clock any more
+        bool songEnded = false;
+        if (options.offscreen && testChannel)
+        {
+            unsigned long long clock = 0;
+            FMOD_RESULT clockResult = testChannel->getDSPClock(&clock, nullptr);
+            while (clockResult == FMOD_OK && double(clock) < offscreenClock)
+            {
+                result = studioSystem->update();
+                if (!fmodErrorCheck(result))
+                {
+                    return -1;
+                }
+                clockResult = testChannel->getDSPClock(&clock, nullptr);
+            }
+            songEnded = clockResult != FMOD_OK;
+        }
 
-        if constexpr (LOGARITHMIC)
+        // The tap stamps blocks with the mixer's clock, that is the channel's parent clock.
+        // Offscreen the audio runs on the fixed time step, so that is the time it maps to.
+        // A replay's clock runs from its first frame, on the fixed time step or at the original pace
+        unsigned long long mixerClock = 0;
+        if (replay && options.offscreen)
+        {
+            mixerClock = (unsigned long long)offscreenClock;
+        }
+        else if (replay)
         {
-            fillCountsLog(counts, data);
+            mixerClock = replay->getStartPosition() + (unsigned long long)(std::chrono::duration<double>(frameTime - offscreenStart).count() * sampleRate);
         }
         else
         {
-            fillCountsLinear(counts, data);
+            bool playing = false;
+            if (testChannel->getDSPClock(nullptr, &mixerClock) != FMOD_OK || testChannel->isPlaying(&playing) != FMOD_OK || !playing)
+            {
+                songEnded = true;
+            }
         }
+        audioClock.sync(mixerClock, options.offscreen ? frameTime : std::chrono::steady_clock::now());
 
-        for (int i = 0; i < BUCKETS; ++i)
+        if (const unsigned int dropped = tap.takeDroppedBlocks())
         {
-            bars.emplace_back(float(i) / BUCKETS + 0.025f * (10.0f / BUCKETS), 0.1f, 0.05f * (10.0f / BUCKETS), 0.6f * counts[i]);
+            std::cout << "ERROR::PCM_TAP::DROPPED_BLOCKS " << dropped << "\n";
         }
 
-        std::vector<std::pair<float, float>> bands;
-        bands.push_back(std::make_pair<float, float>(60, 250));     // Kick
-        bands.push_back(std::make_pair<float, float>(60, 210));     // Toms
-        bands.push_back(std::make_pair<float, float>(120, 250));    // Snare
-        bands.push_back(std::make_pair<float, float>(3000, 5000));  // hi-hat
+        bool onsetAnalysed = false;
+        bool beatInBlocks = false;
+
+        const auto analyse = [&](const int resolution, const SpectrumFrame& analysed) {
+            if (recorder.isOpen())
+            {
+                recorder.write(resolution, analysed);
+            }
+
+            if (resolution == DISPLAY_RESOLUTION)
+            {
+                std::vector<float> counts;
+                counts.resize(BUCKETS);
+
+                filterbank.apply(counts, analysed);
+
+                if constexpr (PERCEPTUAL_MAGNITUDES)
+                {
+                    magnitudeScale.apply(counts);
+                }
+
+                normaliser.process(counts, float(DISPLAY_HOP) / sampleRate);
+
+                interpolator.push(audioClock.toTime(analysed.samplePosition), counts);
+                if constexpr (WATERFALL)
+                {
+                    waterfall->update(counts);
+                }
+                return;
+            }
 
-        const float previousEnergies = std::accumulate(memory.begin(), memory.end(), 0.0f);
-        const float averageEnergy = (1 / float(memory.size())) * previousEnergies;
+            const std::optional<BeatEvent> beat = detector.process(analysed);
 
-        const float currentEnergy = calculateSoundEnergy(data);
-        //const float currentEnergy = calculateSoundEnergyInBands(data, bands);
-        const float variance = calculateEnergyVariance(memory, averageEnergy);
+            onsetAnalysed = true;
+            analysedPosition = analysed.samplePosition;
+            if (beat)
+            {
+                beatInBlocks = true;
 
-        memory[memoryPtr++] = currentEnergy;
+                // Chart mode judges presses against the chart, the live judge would only collect beats
+                if (!judgeEngine)
+                {
+                    hitJudge.addBeat(*beat);
+                }
+            }
+        };
 
-        if (memoryPtr > memory.size() - 1)
+        if (replay)
         {
-            memoryPtr = 0;
+            int resolution = 0;
+            while (replay->next(resolution, frame, mixerClock))
+            {
+                analyse(resolution, frame);
+            }
+
+            if (replay->isFinished())
+            {
+                glfwSetWindowShouldClose(window, true);
+            }
         }
 
-        const float multiplier = -25.714f * variance + 1.5142857f;
-        //const float multiplier = 1.3f;
+        // Every block the mixer produced since the last frame, in order
+        while (const PcmBlock* block = tap.front())
+        {
+            if (!stft)
+            {
+                const std::vector<StftConfig> resolutions{ { FFT_WINDOWS, DISPLAY_HOP }, { ONSET_WINDOW, ONSET_HOP } };
+                stft = std::make_unique<MultiResolutionStft>(ChannelMixer::outputChannels(CHANNEL_LAYOUT, block->channels), resolutions, block->clock);
+                playbackStart = block->clock;
+            }
 
-        std::cout << multiplier << "\n";
+            // Blocks lost to a full queue are replaced by silence, so every later position stays on the DSP clock
+            if (block->clock > stft->getRing().getWritePosition())
+            {
+                stft->writeSilence(int(block->clock - stft->getRing().getWritePosition()));
+            }
 
-        SpectrogramBar* beatBar = nullptr;
-        SpectrogramBar* hitBar = nullptr;
-        if (currentEnergy > multiplier * averageEnergy)
+            mixer.process(block->samples.data(), block->channels, block->frames, mixedPcm);
+            tap.pop();
+
+            // A channel count change midway could only come from a layout that keeps every channel
+            if (mixedPcm.size() != size_t(stft->getRing().getChannels()) * size_t(block->frames))
+            {
+                continue;
+            }
+
+            stft->write(mixedPcm.data(), block->frames);
+            stft->process(frame, analyse);
+        }
+
+        if (onsetAnalysed)
         {
-            beatBar = new SpectrogramBar(0.05f, 0.9f, 0.3f, 0.1f);
+            beatDetected = beatInBlocks;
+            hitDetected = false;
         }
 
-        if (currentEnergy > multiplier * averageEnergy && watch.isOK())
+        KeyPress press;
+        while (watch.poll(press))
         {
-            hitBar = new SpectrogramBar(0.5f, 0.9f, 0.3f, 0.1f);
-            watch.setGraceTime(200);
+            const uint64_t pressPosition = audioClock.toSamples(press.time);
+            if (!press.pressed || pressPosition <= outputLatency)
+            {
+                continue;
+            }
+
+            if (judgeEngine && stft)
+            {
+                const JudgeResult judged = judgeEngine->press(toChartPosition(pressPosition - outputLatency));
+                hitDetected = hitDetected || judged.judgement != Judgement::Miss;
+
+                const char* names[] = { "perfect", "good", "miss" };
+                std::cout << names[int(judged.judgement)] << ", combo " << judgeEngine->getCombo() << ", score " << judgeEngine->getScore() << "\n";
+            }
+            else if (!judgeEngine)
+            {
+                hitJudge.addPress(pressPosition - outputLatency);
+            }
         }
-        else if (watch.isPressed())
+
+        if (judgeEngine && stft && mixerClock > outputLatency)
         {
-            watch.setPenaltyTime(200);
+            if (const int missed = judgeEngine->advance(toChartPosition(mixerClock - outputLatency)))
+            {
+                std::cout << missed << " beat(s) missed, score " << judgeEngine->getScore() << "\n";
+            }
+        }
+
+        if (songEnded)
+        {
+            // Nothing can be pressed any more, whatever is left of the chart is missed
+            if (judgeEngine)
+            {
+                if (const int missed = judgeEngine->advance(std::numeric_limits<uint64_t>::max()))
+                {
+                    std::cout << missed << " beat(s) missed, score " << judgeEngine->getScore() << "\n";
+                }
+            }
+            glfwSetWindowShouldClose(window, true);
         }
 
+        judgedPresses.clear();
+        hitJudge.judge(analysedPosition, judgedPresses);
+        for (const JudgedPress& judged : judgedPresses)
+        {
+            if (judged.hit)
+            {
+                hitDetected = true;
+                std::cout << "hit, " << 1000.0 * judged.offset / sampleRate << " ms off\n";
+            }
+            else
+            {
+                std::cout << "miss\n";
+            }
+        }
+
+        if constexpr (!WATERFALL)
+        {
+            interpolator.sample(frameTime, displayCounts);
+
+            smoother.update(displayCounts, std::chrono::duration<float>(frameTime - previousFrameTime).count());
+            spectrum->update(smoother.getValues(), smoother.getPeaks());
+        }
+        previousFrameTime = frameTime;
+
         // Draw
+        shaders.update();
+
+        if (offscreen)
+        {
+            offscreen->bind();
+        }
+
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        for (const SpectrogramBar& bar : bars)
+        if constexpr (WATERFALL)
         {
-            bar.draw();
+            waterfall->draw();
         }
+        else
+        {
+            spectrum->draw();
+        }
+        SpectrogramBar* beatBar = nullptr;
+        SpectrogramBar* hitBar = nullptr;
+        if (beatDetected)
+        {
+            beatBar = new SpectrogramBar(0.05f, 0.9f, 0.3f, 0.1f);
+        }
+        if (hitDetected)
+        {
+            hitBar = new SpectrogramBar(0.5f, 0.9f, 0.3f, 0.1f);
+        }
+
         if (beatBar)
         {
             beatBar->draw();
@@ -392,19 +719,33 @@ int main()
             hitBar = nullptr;
         }
 
+        if (offscreen)
+        {
+            offscreen->readback();
+            offscreen->unbind();
+            writeFrames(false);
+            ++renderedFrames;
+        }
+
         // Upkeep
         processInput(window);
         glfwSwapBuffers(window);
         glfwPollEvents();
 
-        bars.clear();
-
         // Time measurement
         const std::chrono::steady_clock::time_point later{ std::chrono::steady_clock::now() };
         std::cout << "Time difference = " << std::chrono::duration_cast<std::chrono::milliseconds>(later - earlier).count() << " ms\n";
         earlier = later;
     }
 
+    if (judgeEngine)
+    {
+        std::cout << "Score " << judgeEngine->getScore() << ", max combo " << judgeEngine->getMaxCombo() << ", perfect " << judgeEngine->getCount(Judgement::Perfect)
+                  << ", good " << judgeEngine->getCount(Judgement::Good) << ", miss " << judgeEngine->getCount(Judgement::Miss) << "\n";
+    }
+
+    tap.detach();
+
     result = studioSystem->release();
     if (!fmodErrorCheck(result))
     {
@@ -412,8 +753,20 @@ int main()
         return -1;
     }
 
+    if (offscreen)
+    {
+        writeFrames(true);
+        offscreen.reset();
+    }
+
+    spectrum.reset();
+    waterfall.reset();
+    shaders.releasePrograms();
     glfwTerminate();
 
-    system("pause");
+    if (!options.offscreen)
+    {
+        system("pause");
+    }
     return 0;
 }
\ No newline at end of file